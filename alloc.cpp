@@ -0,0 +1,94 @@
+#include "alloc.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static std::atomic<uint64_t> allocations{0};
+static std::atomic<uint64_t> allocatedBytes{0};
+static thread_local uint64_t threadAllocations = 0;
+
+static void* CountedAlloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    threadAllocations++;
+    return malloc(size ? size : 1);
+}
+
+// Over-aligned types (alignas beyond what malloc guarantees) come through
+// the align_val_t overloads. Windows can't free() these, so they get their
+// own free.
+static void* CountedAlignedAlloc(size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    threadAllocations++;
+    size_t align = (size_t)alignment < sizeof(void*) ? sizeof(void*) : (size_t)alignment;
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, align, size ? size : 1) == 0 ? p : nullptr;
+#endif
+}
+
+static void AlignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void* operator new(size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* p = CountedAlignedAlloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* p = CountedAlignedAlloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlignedAlloc(size, alignment); }
+
+void operator delete(void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(p); }
+
+uint64_t AllocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocatedBytes() {
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t ThreadAllocationCount() {
+    return threadAllocations;
+}
@@ -0,0 +1,16 @@
+#ifndef PONG_ALLOC_H
+#define PONG_ALLOC_H
+
+#include <cstdint>
+
+// Heap allocation counting. The game and pong_bench link this in place of
+// the standard operator new (aligned forms included), so every C++
+// allocation on any thread is counted here; raylib's and miniaudio's own
+// malloc calls are not. Steady-state frames should leave these unchanged:
+// pools and buffers are sized at init or when a match starts.
+
+uint64_t AllocationCount();       // All threads, since startup
+uint64_t AllocatedBytes();        // Same, bytes requested
+uint64_t ThreadAllocationCount(); // The calling thread only
+
+#endif //PONG_ALLOC_H
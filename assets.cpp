@@ -0,0 +1,79 @@
+#include "assets.h"
+#include <atomic>
+#include <thread>
+
+#ifndef PONG_EMBED_ASSETS
+bool FindEmbeddedAsset(const char*, EmbeddedAsset&) {
+    return false;
+}
+#endif
+
+const char* const SOUND_PATHS[3] = {"sounds/paddle_hit.wav", "sounds/wall_hit.wav", "sounds/score.wav"};
+const char* const ICON_PATH = "C:/Users/youss/Pictures/Pong2.png";
+
+// Filled by the worker, read by the main thread once 'decoded' is set
+struct AssetLoader {
+    std::thread worker;
+    std::atomic<bool> decoded;
+    Wave waves[3];
+    Image icon;
+    bool iconSet;
+};
+
+static AssetLoader loader;
+
+static Wave DecodeWave(const char* path) {
+    EmbeddedAsset asset;
+    if (FindEmbeddedAsset(path, asset)) return LoadWaveFromMemory(".wav", asset.data, asset.size);
+    return LoadWave(path);
+}
+
+static Image DecodeIcon() {
+    EmbeddedAsset asset;
+    if (FindEmbeddedAsset(ICON_PATH, asset)) return LoadImageFromMemory(".png", asset.data, asset.size);
+    return LoadImage(ICON_PATH);
+}
+
+void StartLoadingAssets() {
+    loader.decoded = false;
+    loader.iconSet = false;
+    loader.worker = std::thread([]() {
+        loader.icon = DecodeIcon();
+        for (int i = 0; i < 3; i++) loader.waves[i] = DecodeWave(SOUND_PATHS[i]);
+        loader.decoded.store(true, std::memory_order_release);
+    });
+}
+
+bool FinishLoadingAssets(GameSounds& sounds) {
+    if (sounds.loaded) return true;
+    if (!loader.decoded.load(std::memory_order_acquire)) return false;
+    if (loader.worker.joinable()) loader.worker.join();
+
+    if (!loader.iconSet) {
+        if (IsImageValid(loader.icon)) SetWindowIcon(loader.icon);
+        UnloadImage(loader.icon);
+        loader.iconSet = true;
+    }
+    if (!IsAudioDeviceReady()) return false;
+
+    Sound* targets[3] = {&sounds.paddleHit, &sounds.wallHit, &sounds.score};
+    for (int i = 0; i < 3; i++) {
+        *targets[i] = LoadSoundFromWave(loader.waves[i]);
+        UnloadWave(loader.waves[i]);
+    }
+    sounds.loaded = true;
+    return true;
+}
+
+void UnloadAssets(GameSounds& sounds) {
+    if (loader.worker.joinable()) loader.worker.join();
+    if (sounds.loaded) {
+        UnloadSound(sounds.paddleHit);
+        UnloadSound(sounds.wallHit);
+        UnloadSound(sounds.score);
+        sounds.loaded = false;
+    } else if (loader.decoded) {
+        if (!loader.iconSet) UnloadImage(loader.icon);
+        for (Wave& wave : loader.waves) UnloadWave(wave);
+    }
+}
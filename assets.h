@@ -0,0 +1,33 @@
+#ifndef PONG_ASSETS_H
+#define PONG_ASSETS_H
+
+#include <raylib.h>
+
+// Startup assets. Sounds and the icon are decoded on a worker thread while
+// the menu is already drawing; the game plays silently until they're in.
+// Built with PONG_EMBED_ASSETS the files are compiled into the executable
+// and nothing is read from disk.
+
+struct EmbeddedAsset {
+    const char* name; // Path it would otherwise be loaded from
+    const unsigned char* data;
+    int size;
+};
+
+bool FindEmbeddedAsset(const char* name, EmbeddedAsset& asset);
+
+struct GameSounds {
+    Sound paddleHit;
+    Sound wallHit;
+    Sound score;
+    bool loaded;
+};
+
+void StartLoadingAssets(); // Before the first frame
+
+// Once a frame: hands the decoded icon to the window and, once the audio
+// device is up, the waves to it. Returns true when everything is in.
+bool FinishLoadingAssets(GameSounds& sounds);
+void UnloadAssets(GameSounds& sounds); // Waits for the worker if it's still going
+
+#endif //PONG_ASSETS_H
@@ -0,0 +1,110 @@
+#include "audio.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+void InitVoicePool(VoicePool& pool, Sound source, int voices) {
+    if (voices < 1) voices = 1;
+    if (voices > MAX_VOICES) voices = MAX_VOICES;
+    pool.voices[0] = source;
+    for (int i = 1; i < voices; i++) pool.voices[i] = LoadSoundAlias(source);
+    for (int i = 0; i < voices; i++) pool.started[i] = 0.0;
+    pool.count = voices;
+    pool.next = 0;
+}
+
+void UnloadVoicePool(VoicePool& pool) {
+    for (int i = 1; i < pool.count; i++) UnloadSoundAlias(pool.voices[i]);
+    pool.count = 0;
+}
+
+static void NoteSoundEvent();
+
+void PlayVoice(VoicePool& pool) {
+    if (pool.count == 0) return;
+
+    // Next free voice from the round-robin cursor, else the oldest one
+    int voice = -1;
+    for (int i = 0; i < pool.count && voice < 0; i++) {
+        int candidate = (pool.next + i) % pool.count;
+        if (!IsSoundPlaying(pool.voices[candidate])) voice = candidate;
+    }
+    if (voice < 0) {
+        voice = 0;
+        for (int i = 1; i < pool.count; i++) {
+            if (pool.started[i] < pool.started[voice]) voice = i;
+        }
+        StopSound(pool.voices[voice]);
+    }
+
+    PlaySound(pool.voices[voice]);
+    pool.started[voice] = GetTime();
+    pool.next = (voice + 1) % pool.count;
+    NoteSoundEvent();
+}
+
+// Audio latency. The main thread sets 'pending' to the time of a play; the
+// audio thread takes it in the next mix and records the sample.
+struct AudioLatency {
+    std::atomic<double> pending; // Seconds, 0 = none
+    std::atomic<float> samples[AUDIO_LATENCY_SAMPLES]; // Milliseconds, ring
+    std::atomic<int> count;
+    bool attached;
+};
+
+static AudioLatency audioLatency;
+
+static double Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void NoteSoundEvent() {
+    if (!audioLatency.attached) return;
+    double none = 0.0;
+    audioLatency.pending.compare_exchange_strong(none, Now()); // Keep the older one
+}
+
+// Runs on the audio thread after every mix. The mix rate is learnt from
+// the callbacks themselves; raylib doesn't expose the device's.
+static void OnAudioMixed(void*, unsigned int frames) {
+    static double firstMix = 0.0;
+    static double mixedFrames = 0.0;
+    double now = Now();
+    if (firstMix == 0.0) firstMix = now;
+    mixedFrames += frames;
+    double rate = now > firstMix + 0.1 ? mixedFrames / (now - firstMix) : 48000.0;
+
+    double event = audioLatency.pending.exchange(0.0);
+    if (event == 0.0) return;
+    float ms = (float)((now - event + frames / rate) * 1000.0);
+    int count = audioLatency.count.load(std::memory_order_relaxed);
+    audioLatency.samples[count % AUDIO_LATENCY_SAMPLES].store(ms, std::memory_order_relaxed);
+    audioLatency.count.store(count + 1, std::memory_order_release);
+}
+
+void StartAudioLatency() {
+    if (audioLatency.attached) return;
+    audioLatency.pending = 0.0;
+    AttachAudioMixedProcessor(OnAudioMixed);
+    audioLatency.attached = true;
+}
+
+void StopAudioLatency() {
+    if (!audioLatency.attached) return;
+    DetachAudioMixedProcessor(OnAudioMixed);
+    audioLatency.attached = false;
+}
+
+int AudioLatencyCount() {
+    return audioLatency.count.load(std::memory_order_acquire);
+}
+
+float AudioLatencyPercentile(float percentile) {
+    int count = std::min(AudioLatencyCount(), AUDIO_LATENCY_SAMPLES);
+    if (count == 0) return 0.0f;
+    float sorted[AUDIO_LATENCY_SAMPLES];
+    for (int i = 0; i < count; i++) sorted[i] = audioLatency.samples[i].load(std::memory_order_relaxed);
+    std::sort(sorted, sorted + count);
+    int index = (int)(percentile / 100.0f * (count - 1) + 0.5f);
+    return sorted[index];
+}
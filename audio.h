@@ -0,0 +1,35 @@
+#ifndef PONG_AUDIO_H
+#define PONG_AUDIO_H
+
+#include <raylib.h>
+
+// Voice pools: a Sound plays one instance at a time and PlaySound restarts
+// it, so quick hits cut each other off. A pool holds aliases of one sound
+// (they share its samples) and each play takes the next free one round
+// robin, or steals the one that has been playing longest.
+
+const int MAX_VOICES = 8;
+const int DEFAULT_VOICES = 4;
+
+struct VoicePool {
+    Sound voices[MAX_VOICES]; // [0] is the source, the rest aliases
+    double started[MAX_VOICES];
+    int count;
+    int next;
+};
+
+void InitVoicePool(VoicePool& pool, Sound source, int voices); // Needs the audio device
+void UnloadVoicePool(VoicePool& pool); // The aliases; the source is the caller's
+void PlayVoice(VoicePool& pool);
+
+// Event to audio output: from a PlayVoice to the end of the first mix that
+// includes it, plus that mix's length for the device to play it out. Mixes
+// are seen through a mixed-audio processor on the audio thread.
+const int AUDIO_LATENCY_SAMPLES = 256;
+
+void StartAudioLatency(); // After InitAudioDevice
+void StopAudioLatency();  // Before CloseAudioDevice
+int AudioLatencyCount();
+float AudioLatencyPercentile(float percentile); // Milliseconds
+
+#endif //PONG_AUDIO_H
@@ -0,0 +1,413 @@
+// pong_bench - microbenchmarks for the physics, bot, particle and chaos mode hot paths
+//
+//   pong_bench [--filter TEXT] [--min-time SECONDS] [--json FILE]
+//
+// Every benchmark runs over a table of ball states at a given speed and
+// angle (random positions, so branches aren't all taken the same way) and
+// reports the median ns/op of five runs and heap allocations per op.
+// Chaos mode is timed per whole step (ball-ball, walls, paddles, bot) over
+// a range of ball counts, the expert bot per frame of a match at each budget
+// (it should come out just under the budget), the training batch env per
+// step next to the same games stepped one by one. Whole bot matches are timed
+// both stepped frame by frame and fast-forwarded between events.
+
+#include "alloc.h"
+#include "batch_env.h"
+#include "chaos.h"
+#include "core.h"
+#include "fast_forward.h"
+#include "particles.h"
+#include "predict.h"
+#include "search_bot.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Keeps the compiler from dropping a result nobody reads
+template <typename T>
+static void Keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *(const volatile char*)&value;
+#endif
+}
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchResult {
+    std::string name;
+    std::string params; // JSON object body, e.g. "speed": 4, "angle": 45
+    double nsPerOp;
+    double allocsPerOp;
+    long ops;
+};
+
+static std::vector<BenchResult> results;
+static double minTime = 0.5;
+static const char* filter = nullptr;
+
+static bool Selected(const char* name) {
+    return !filter || strstr(name, filter);
+}
+
+static void Report(const char* name, const std::string& params, const std::vector<double>& runs, long allocs, long ops) {
+    std::vector<double> sorted = runs;
+    std::sort(sorted.begin(), sorted.end());
+    BenchResult result = {name, params, sorted[sorted.size() / 2], (double)allocs / ops, ops};
+    printf("%-24s %-32s %10.2f ns/op %8.3f allocs/op\n", name, params.c_str(), result.nsPerOp, result.allocsPerOp);
+    results.push_back(result);
+}
+
+// Cheap ops: timed in batches, op(i) gets a running counter
+template <typename Op>
+static void Measure(const char* name, const std::string& params, Op op) {
+    const int RUNS = 5;
+    const long BATCH = 1024;
+    std::vector<double> runs;
+    long allocs = 0;
+    long totalOps = 0;
+    long counter = 0;
+
+    for (int run = 0; run < RUNS; run++) {
+        long ops = 0;
+        double elapsed = 0.0;
+        uint64_t allocStart = AllocationCount();
+        while (elapsed < minTime / RUNS) {
+            auto start = Clock::now();
+            for (long i = 0; i < BATCH; i++) op(counter++);
+            elapsed += std::chrono::duration<double>(Clock::now() - start).count();
+            ops += BATCH;
+        }
+        allocs += (long)(AllocationCount() - allocStart);
+        totalOps += ops;
+        runs.push_back(elapsed * 1e9 / ops);
+    }
+    Report(name, params, runs, allocs, totalOps);
+}
+
+// Expensive ops that need untimed setup before each call
+template <typename Setup, typename Op>
+static void MeasureWithSetup(const char* name, const std::string& params, Setup setup, Op op) {
+    const int RUNS = 5;
+    std::vector<double> runs;
+    long allocs = 0;
+    long totalOps = 0;
+
+    for (int run = 0; run < RUNS; run++) {
+        long ops = 0;
+        double elapsed = 0.0;
+        while (elapsed < minTime / RUNS) {
+            setup();
+            uint64_t allocStart = AllocationCount();
+            auto start = Clock::now();
+            op();
+            elapsed += std::chrono::duration<double>(Clock::now() - start).count();
+            allocs += (long)(AllocationCount() - allocStart);
+            ops++;
+        }
+        totalOps += ops;
+        runs.push_back(elapsed * 1e9 / ops);
+    }
+    Report(name, params, runs, allocs, totalOps);
+}
+
+// Ball states at one speed and angle
+const int CASES = 1024; // Power of two
+
+struct BallCase {
+    Circle circle;
+    Vector2 oldPosition;
+    Rectangle player;
+    Rectangle bot;
+};
+
+static std::vector<BallCase> MakeCases(float speed, float angle, Collisions collision) {
+    Rng rng;
+    SeedRng(rng, 42);
+    std::vector<BallCase> cases(CASES);
+    for (BallCase& c : cases) {
+        float x = (float)RandomValue(rng, BALL_RADIUS, SCREEN_WIDTH - BALL_RADIUS);
+        float y = (float)RandomValue(rng, PLAY_AREA_TOP + BALL_RADIUS, PLAY_AREA_BOTTOM - BALL_RADIUS);
+        float radians = angle * 3.14159265f / 180.0f;
+        float vx = speed * cosf(radians) * (RandomValue(rng, 0, 1) ? 1.0f : -1.0f);
+        float vy = speed * sinf(radians) * (RandomValue(rng, 0, 1) ? 1.0f : -1.0f);
+        c.circle = {{x, y}, collision};
+        c.oldPosition = {x - vx, y - vy};
+        c.player = {10, (float)RandomValue(rng, PLAY_AREA_TOP, PLAY_AREA_BOTTOM - PADDLE_HEIGHT), PADDLE_WIDTH, PADDLE_HEIGHT};
+        c.bot = {SCREEN_WIDTH - 30.0f, (float)RandomValue(rng, PLAY_AREA_TOP, PLAY_AREA_BOTTOM - PADDLE_HEIGHT), PADDLE_WIDTH, PADDLE_HEIGHT};
+    }
+    return cases;
+}
+
+static void BenchBall(float speed, float angle) {
+    char params[64];
+    snprintf(params, sizeof(params), "\"speed\": %g, \"angle\": %g", speed, angle);
+    std::vector<BallCase> cases = MakeCases(speed, angle, NO_COL);
+    std::vector<BallCase> hits = MakeCases(speed, angle, PLAYER_COL); // What the bots see after a return
+
+    if (Selected("move")) {
+        Rng rng;
+        SeedRng(rng, 1);
+        EventList events;
+        Measure("move", params, [&](long i) {
+            const BallCase& c = cases[i & (CASES - 1)];
+            Circle circle = c.circle;
+            Vector2 oldPosition = c.oldPosition;
+            float currentSpeed = speed;
+            events.count = 0;
+            Keep(move(circle, oldPosition, BALL_SPEED, c.player, c.bot, currentSpeed, rng, events));
+            Keep(circle);
+        });
+    }
+    if (Selected("CircleCollideWith")) {
+        Measure("CircleCollideWith", params, [&](long i) {
+            const BallCase& c = cases[i & (CASES - 1)];
+            Circle circle = c.circle;
+            CircleCollideWith(circle, c.player, c.bot);
+            Keep(circle);
+        });
+        Measure("CircleCollideWith/swept", params, [&](long i) {
+            const BallCase& c = cases[i & (CASES - 1)];
+            Circle circle = c.circle;
+            CircleCollideWith(circle, c.oldPosition, c.player, c.bot);
+            Keep(circle);
+        });
+    }
+    if (Selected("PointOfCollision")) {
+        Measure("PointOfCollision", params, [&](long i) {
+            const BallCase& c = cases[i & (CASES - 1)];
+            Keep(PointOfCollision(c.circle, c.oldPosition));
+        });
+    }
+    if (Selected("RightBorderCollision")) {
+        Measure("RightBorderCollision", params, [&](long i) {
+            const BallCase& c = cases[i & (CASES - 1)];
+            Keep(RightBorderCollision(c.circle, c.oldPosition));
+        });
+    }
+    if (Selected("PredictCollision")) {
+        Measure("PredictCollision", params, [&](long i) {
+            const BallCase& c = cases[i & (CASES - 1)];
+            Keep(PredictCollision(c.circle, c.oldPosition));
+        });
+    }
+    if (Selected("PredictRightIntercept")) {
+        Measure("PredictRightIntercept", params, [&](long i) {
+            const BallCase& c = cases[i & (CASES - 1)];
+            Keep(PredictRightIntercept(c.circle.center, c.circle.center - c.oldPosition));
+        });
+    }
+    if (Selected("IncreaseSpeed")) {
+        Measure("IncreaseSpeed", params, [&](long i) {
+            const BallCase& c = cases[i & (CASES - 1)];
+            Vector2 velocity = c.circle.center - c.oldPosition;
+            float currentSpeed = speed;
+            IncreaseSpeed(c.circle, velocity, currentSpeed);
+            Keep(velocity);
+            Keep(currentSpeed);
+        });
+    }
+    if (Selected("moveBotMedium")) {
+        Measure("moveBotMedium", params, [&](long i) {
+            const BallCase& c = hits[i & (CASES - 1)];
+            Rectangle bot = c.bot;
+            Circle future = c.circle;
+            moveBotMedium(bot, c.circle, c.oldPosition, future);
+            Keep(bot);
+            Keep(future);
+        });
+    }
+    if (Selected("moveBotHard")) {
+        Measure("moveBotHard", params, [&](long i) {
+            const BallCase& c = hits[i & (CASES - 1)];
+            Rectangle bot = c.bot;
+            Circle future = c.circle;
+            moveBotHard(bot, c.circle, c.oldPosition, future);
+            Keep(bot);
+            Keep(future);
+        });
+    }
+}
+
+static void BenchParticles(int count) {
+    char params[64];
+    snprintf(params, sizeof(params), "\"particles\": %d", count);
+    ParticlePool pool;
+    InitParticlePool(pool, count);
+    Rng rng;
+    SeedRng(rng, 7);
+
+    if (Selected("UpdateParticles")) {
+        // A full pool at mixed ages, so about one in a hundred dies per update
+        MeasureWithSetup("UpdateParticles", params, [&]() {
+            ClearParticles(pool);
+            SpawnParticles(pool, rng, {SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, Color{255, 255, 255, 255}, count);
+            for (int i = 0; i < pool.count; i++) pool.lifetime[i] = RandomValue(rng, 1, 1000) / 1000.0f;
+        }, [&]() {
+            UpdateParticles(pool, 1.0f / SIM_HZ);
+        });
+    }
+    if (Selected("SpawnParticles")) {
+        // Bursts the size the game uses, into a pool of this size
+        for (int burst : {12, 30}) {
+            char burstParams[96];
+            snprintf(burstParams, sizeof(burstParams), "%s, \"burst\": %d", params, burst);
+            ClearParticles(pool);
+            Measure("SpawnParticles", burstParams, [&](long) {
+                if (pool.count + burst > pool.capacity) ClearParticles(pool);
+                SpawnParticles(pool, rng, {SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, Color{255, 255, 255, 255}, burst);
+            });
+        }
+    }
+}
+
+static void BenchChaos(int count) {
+    if (!Selected("StepChaos")) return;
+    char params[64];
+    snprintf(params, sizeof(params), "\"balls\": %d", count);
+    ChaosWorld chaos;
+    InitChaos(chaos, count, 3);
+    // Past the first steps, which mostly push apart overlapping spawns
+    for (int i = 0; i < 240; i++) StepChaos(chaos, 0);
+
+    long frame = 0;
+    MeasureWithSetup("StepChaos", params, []() {}, [&]() {
+        StepChaos(chaos, (frame++ / 60) % 2 ? INPUT_UP : INPUT_DOWN);
+    });
+}
+
+static void BenchSearch(int budget) {
+    if (!Selected("ThinkSearchBot")) return;
+    char params[64];
+    snprintf(params, sizeof(params), "\"budget_us\": %d", budget);
+    SearchBot bot;
+    InitSearchBot(bot);
+    World world;
+    ResetWorld(world, EXPERT, 5);
+
+    // Against a left paddle that follows the ball
+    MeasureWithSetup("ThinkSearchBot", params, []() {}, [&]() {
+        uint8_t input = ThinkSearchBot(bot, world, budget);
+        input |= world.circle.center.y < world.player.y + PADDLE_HEIGHT / 2 ? INPUT_UP : INPUT_DOWN;
+        StepWorld(world, input);
+        if (IsMatchOver(world)) ResetWorld(world, EXPERT, 5);
+    });
+}
+
+// A step of the whole batch, and the same games stepped one World at a time
+static void BenchBatchEnv(int games) {
+    char params[64];
+    snprintf(params, sizeof(params), "\"games\": %d", games);
+    BatchEnv env;
+    InitBatchEnv(env, games, HARD, 9);
+    std::vector<World> worlds(games);
+    for (int i = 0; i < games; i++) LoadBatchGame(env, i, worlds[i]);
+    std::vector<uint8_t> actions(games);
+    Rng rng;
+    SeedRng(rng, 3);
+    auto randomActions = [&]() {
+        for (uint8_t& action : actions) action = (uint8_t)RandomValue(rng, 0, 3);
+    };
+
+    if (Selected("StepBatchEnv")) {
+        MeasureWithSetup("StepBatchEnv", params, randomActions, [&]() {
+            StepBatchEnv(env, actions.data());
+            Keep(env.observations[0]);
+        });
+    }
+    if (Selected("StepWorld/batch")) {
+        MeasureWithSetup("StepWorld/batch", params, randomActions, [&]() {
+            for (int i = 0; i < games; i++) {
+                StepWorld(worlds[i], actions[i]);
+                if (IsMatchOver(worlds[i])) ResetWorld(worlds[i], HARD, worlds[i].rng.state);
+            }
+            Keep(worlds[0].circle.center);
+        });
+    }
+}
+
+// Hard against medium to WIN_SCORE, a new seed every match
+static void BenchMatch(bool fastForward) {
+    if (!Selected("BotMatch")) return;
+    const long MAX_FRAMES = 1000000;
+    World world;
+    uint64_t seed = 1;
+    BotFunction left = BotForDifficulty(HARD);
+    BotFunction right = BotForDifficulty(MEDIUM);
+
+    MeasureWithSetup("BotMatch", fastForward ? "\"stepping\": \"events\"" : "\"stepping\": \"frames\"",
+                     [&]() { ResetWorld(world, EASY, seed++); },
+                     [&]() {
+                         long frames = 0;
+                         while (!IsMatchOver(world) && frames < MAX_FRAMES) {
+                             if (fastForward) {
+                                 frames += FastForwardBots(world, left, right, MAX_FRAMES - frames);
+                             } else {
+                                 StepWorldBots(world, left, right);
+                                 frames++;
+                             }
+                         }
+                         Keep(world.circle.center);
+                     });
+}
+
+static bool WriteJson(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    fprintf(file, "{\n  \"min_time\": %g,\n  \"benchmarks\": [\n", minTime);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"params\": {%s}, \"ns_per_op\": %.3f, \"allocs_per_op\": %.4f, \"ops\": %ld}%s\n",
+                r.name.c_str(), r.params.c_str(), r.nsPerOp, r.allocsPerOp, r.ops, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+int main(int argc, char** argv) {
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--json") == 0 && next) jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--filter") == 0 && next) filter = argv[++i];
+        else if (strcmp(argv[i], "--min-time") == 0 && next) minTime = atof(argv[++i]);
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    for (float speed : {4.0f, 16.0f, 64.0f}) {
+        for (float angle : {15.0f, 45.0f, 75.0f}) {
+            BenchBall(speed, angle);
+        }
+    }
+    for (int count : {1000, 10000, 100000}) {
+        BenchParticles(count);
+    }
+    for (int count : {250, 500, 1000, 2000, 4000, 8000}) {
+        BenchChaos(count);
+    }
+    for (int budget : {50, 200}) {
+        BenchSearch(budget);
+    }
+    for (int games : {64, 1024}) {
+        BenchBatchEnv(games);
+    }
+    for (bool fastForward : {false, true}) {
+        BenchMatch(fastForward);
+    }
+
+    if (jsonPath && !WriteJson(jsonPath)) {
+        fprintf(stderr, "Could not write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
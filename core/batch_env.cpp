@@ -0,0 +1,232 @@
+#include "batch_env.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PONG_BATCH_SSE
+#endif
+
+// A ball is in open play when it and its previous position are clear of
+// both paddles (grown by the radius) and inside the walls: then the frame is
+// just "keep going", no scoring, no collision and no new bot prediction
+const float LEFT_CLEAR = 10 + PADDLE_WIDTH + BALL_RADIUS;
+const float RIGHT_CLEAR = SCREEN_WIDTH - 30 - BALL_RADIUS;
+const float TOP_LIMIT = PLAY_AREA_TOP + BALL_RADIUS;
+const float BOTTOM_LIMIT = PLAY_AREA_BOTTOM - BALL_RADIUS;
+
+void InitBatchEnv(BatchEnv& env, int count, Difficulty difficulty, uint64_t seed) {
+    if (count < 0) count = 0;
+    // Padded to whole SIMD lanes
+    int padded = (count + 3) & ~3;
+    env.count = count;
+    // The expert bot needs a search tree per game; it trains against HARD
+    env.difficulty = difficulty == EXPERT ? HARD : difficulty;
+
+    env.ballX.assign(padded, 0.0f);
+    env.ballY.assign(padded, 0.0f);
+    env.oldX.assign(padded, 0.0f);
+    env.oldY.assign(padded, 0.0f);
+    env.playerY.assign(padded, 0.0f);
+    env.botY.assign(padded, 0.0f);
+    env.futureX.assign(padded, 0.0f);
+    env.futureY.assign(padded, 0.0f);
+    env.futureCollision.assign(padded, NO_COL);
+    env.currentSpeed.assign(padded, BALL_SPEED);
+    env.playerScore.assign(padded, 0);
+    env.botScore.assign(padded, 0);
+    env.rng.assign(padded, Rng{0});
+
+    env.observations.assign((size_t)count * OBSERVATION_SIZE, 0.0f);
+    env.rewards.assign(count, 0.0f);
+    env.dones.assign(count, 0);
+
+    Rng seeds;
+    SeedRng(seeds, seed);
+    for (int i = 0; i < count; i++) {
+        SeedRng(env.rng[i], RandomBits(seeds));
+        ResetBatchGame(env, i);
+    }
+}
+
+void LoadBatchGame(const BatchEnv& env, int index, World& world) {
+    world.circle = {{env.ballX[index], env.ballY[index]}, NO_COL};
+    world.OldPosition = {env.oldX[index], env.oldY[index]};
+    world.futureCollision = {{env.futureX[index], env.futureY[index]}, (Collisions)env.futureCollision[index]};
+    world.playerFuture = {}; // Only used when a bot plays the left paddle
+    world.player = {10, env.playerY[index], PADDLE_WIDTH, PADDLE_HEIGHT};
+    world.bot = {SCREEN_WIDTH - 30.0f, env.botY[index], PADDLE_WIDTH, PADDLE_HEIGHT};
+    world.playerScore = env.playerScore[index];
+    world.botScore = env.botScore[index];
+    world.currentSpeed = env.currentSpeed[index];
+    world.difficulty = env.difficulty;
+    world.subSteps = 1;
+    world.rng = env.rng[index];
+    world.events.count = 0;
+}
+
+void StoreBatchGame(BatchEnv& env, int index, const World& world) {
+    env.ballX[index] = world.circle.center.x;
+    env.ballY[index] = world.circle.center.y;
+    env.oldX[index] = world.OldPosition.x;
+    env.oldY[index] = world.OldPosition.y;
+    env.futureX[index] = world.futureCollision.center.x;
+    env.futureY[index] = world.futureCollision.center.y;
+    env.futureCollision[index] = world.futureCollision.Collision;
+    env.playerY[index] = world.player.y;
+    env.botY[index] = world.bot.y;
+    env.playerScore[index] = world.playerScore;
+    env.botScore[index] = world.botScore;
+    env.currentSpeed[index] = world.currentSpeed;
+    env.rng[index] = world.rng;
+}
+
+void ResetBatchGame(BatchEnv& env, int index) {
+    World world;
+    // The game's generator carries on into the next match
+    ResetWorld(world, env.difficulty, env.rng[index].state);
+    StoreBatchGame(env, index, world);
+}
+
+// Everything that isn't open play: exactly what the game does
+static void StepGame(BatchEnv& env, int index, uint8_t action) {
+    World world;
+    LoadBatchGame(env, index, world);
+    StepWorld(world, action);
+
+    for (int e = 0; e < world.events.count; e++) {
+        if (world.events.items[e].type == SCORE) {
+            env.rewards[index] += world.events.items[e].side == LEFT_SIDE ? 1.0f : -1.0f;
+        }
+    }
+
+    StoreBatchGame(env, index, world);
+    if (IsMatchOver(world)) {
+        env.dones[index] = 1;
+        ResetBatchGame(env, index);
+    }
+}
+
+#ifdef PONG_BATCH_SSE
+// Open-play frames for four games at once, the same float operations as
+// StepWorld -> move -> moveBot* in the same order. Returns a bit per lane
+// that still needs the full rules (nothing is written for those lanes).
+static int StepOpenPlay(BatchEnv& env, int i, const uint8_t* actions) {
+    float* bx = env.ballX.data() + i;
+    float* by = env.ballY.data() + i;
+    float* ox = env.oldX.data() + i;
+    float* oy = env.oldY.data() + i;
+    float* py = env.playerY.data() + i;
+    float* boty = env.botY.data() + i;
+
+    __m128 ballX = _mm_loadu_ps(bx);
+    __m128 ballY = _mm_loadu_ps(by);
+    __m128 oldX = _mm_loadu_ps(ox);
+    __m128 oldY = _mm_loadu_ps(oy);
+    __m128 player = _mm_loadu_ps(py);
+    __m128 bot = _mm_loadu_ps(boty);
+
+    const __m128 leftClear = _mm_set1_ps(LEFT_CLEAR);
+    const __m128 rightClear = _mm_set1_ps(RIGHT_CLEAR);
+    const __m128 top = _mm_set1_ps(PLAY_AREA_TOP);
+    const __m128 bottom = _mm_set1_ps(PLAY_AREA_BOTTOM);
+    const __m128 height = _mm_set1_ps(PADDLE_HEIGHT);
+    const __m128 halfHeight = _mm_set1_ps(PADDLE_HEIGHT / 2);
+
+    // Padding lanes past the end of the batch never come out quiet and are skipped
+    __m128 quiet = _mm_and_ps(_mm_cmpgt_ps(ballX, leftClear), _mm_cmplt_ps(ballX, rightClear));
+    quiet = _mm_and_ps(quiet, _mm_and_ps(_mm_cmpgt_ps(oldX, leftClear), _mm_cmplt_ps(oldX, rightClear)));
+    quiet = _mm_and_ps(quiet, _mm_cmpge_ps(ballY, _mm_set1_ps(TOP_LIMIT)));
+    quiet = _mm_and_ps(quiet, _mm_cmple_ps(ballY, _mm_set1_ps(BOTTOM_LIMIT)));
+    quiet = _mm_and_ps(quiet, _mm_or_ps(_mm_cmpneq_ps(ballX, oldX), _mm_cmpneq_ps(ballY, oldY))); // OldPosition == center means a serve
+
+    // Player controls
+    int32_t upBits[4];
+    int32_t downBits[4];
+    for (int lane = 0; lane < 4; lane++) {
+        uint8_t action = (i + lane < env.count) ? actions[i + lane] : 0;
+        upBits[lane] = (action & INPUT_UP) ? -1 : 0;
+        downBits[lane] = (action & INPUT_DOWN) ? -1 : 0;
+    }
+    __m128 up = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)upBits));
+    __m128 down = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)downBits));
+    const __m128 playerSpeed = _mm_set1_ps(PLAYER_SPEED);
+
+    __m128 moveUp = _mm_and_ps(up, _mm_cmpgt_ps(player, top));
+    player = _mm_or_ps(_mm_andnot_ps(moveUp, player), _mm_and_ps(moveUp, _mm_sub_ps(player, playerSpeed)));
+    __m128 moveDown = _mm_and_ps(down, _mm_cmplt_ps(_mm_add_ps(player, height), bottom));
+    player = _mm_or_ps(_mm_andnot_ps(moveDown, player), _mm_and_ps(moveDown, _mm_add_ps(player, playerSpeed)));
+
+    // Ball keeps its velocity
+    __m128 velX = _mm_sub_ps(ballX, oldX);
+    __m128 velY = _mm_sub_ps(ballY, oldY);
+    oldX = ballX;
+    oldY = ballY;
+    ballX = _mm_add_ps(ballX, velX);
+    ballY = _mm_add_ps(ballY, velY);
+
+    // Bot: no new prediction without a collision, so it just chases its target
+    __m128 target = ballY;
+    float step = 5.0f;
+    if (env.difficulty == HARD) {
+        target = _mm_loadu_ps(env.futureY.data() + i);
+        step = 7.0f;
+    } else if (env.difficulty == MEDIUM) {
+        __m128 hasTarget = _mm_castsi128_ps(_mm_cmpeq_epi32(
+            _mm_loadu_si128((const __m128i*)(env.futureCollision.data() + i)), _mm_set1_epi32(RIGHT_BORDER)));
+        target = _mm_or_ps(_mm_andnot_ps(hasTarget, ballY), _mm_and_ps(hasTarget, _mm_loadu_ps(env.futureY.data() + i)));
+    }
+    const __m128 botSpeed = _mm_set1_ps(step);
+    __m128 botCenterLine = _mm_add_ps(bot, halfHeight);
+    __m128 botDown = _mm_and_ps(_mm_cmpgt_ps(target, botCenterLine), _mm_cmplt_ps(_mm_add_ps(bot, height), bottom));
+    bot = _mm_or_ps(_mm_andnot_ps(botDown, bot), _mm_and_ps(botDown, _mm_add_ps(bot, botSpeed)));
+    __m128 botUp = _mm_and_ps(_mm_cmplt_ps(target, botCenterLine), _mm_cmpgt_ps(bot, top));
+    bot = _mm_or_ps(_mm_andnot_ps(botUp, bot), _mm_and_ps(botUp, _mm_sub_ps(bot, botSpeed)));
+
+    // Only open-play lanes take the new values
+    auto keep = [&quiet](float* dst, __m128 value) {
+        __m128 old = _mm_loadu_ps(dst);
+        _mm_storeu_ps(dst, _mm_or_ps(_mm_andnot_ps(quiet, old), _mm_and_ps(quiet, value)));
+    };
+    keep(bx, ballX);
+    keep(by, ballY);
+    keep(ox, oldX);
+    keep(oy, oldY);
+    keep(py, player);
+    keep(boty, bot);
+
+    return ~_mm_movemask_ps(quiet) & 0xF;
+}
+#endif
+
+static void WriteObservation(BatchEnv& env, int i) {
+    float* obs = env.observations.data() + (size_t)i * OBSERVATION_SIZE;
+    obs[0] = env.ballX[i] / SCREEN_WIDTH * 2.0f - 1.0f;
+    obs[1] = env.ballY[i] / SCREEN_HEIGHT * 2.0f - 1.0f;
+    obs[2] = (env.ballX[i] - env.oldX[i]) / BALL_SPEED / 4.0f;
+    obs[3] = (env.ballY[i] - env.oldY[i]) / BALL_SPEED / 4.0f;
+    obs[4] = (env.playerY[i] + PADDLE_HEIGHT / 2) / SCREEN_HEIGHT * 2.0f - 1.0f;
+    obs[5] = (env.botY[i] + PADDLE_HEIGHT / 2) / SCREEN_HEIGHT * 2.0f - 1.0f;
+}
+
+void StepBatchEnv(BatchEnv& env, const uint8_t* actions) {
+    for (int i = 0; i < env.count; i++) {
+        env.rewards[i] = 0.0f;
+        env.dones[i] = 0;
+    }
+
+#ifdef PONG_BATCH_SSE
+    for (int i = 0; i < env.count; i += 4) {
+        int slow = StepOpenPlay(env, i, actions);
+        for (int lane = 0; slow != 0; lane++, slow >>= 1) {
+            if ((slow & 1) && i + lane < env.count) StepGame(env, i + lane, actions[i + lane]);
+        }
+    }
+#else
+    for (int i = 0; i < env.count; i++) {
+        StepGame(env, i, actions[i]);
+    }
+#endif
+
+    for (int i = 0; i < env.count; i++) {
+        WriteObservation(env, i);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef PONG_BATCH_ENV_H
+#define PONG_BATCH_ENV_H
+
+#include <cstdint>
+#include <vector>
+#include "core.h"
+
+// N independent matches stepped together for bot training. The agent
+// drives the left paddle with InputBits, the right paddle is the built-in
+// bot. State is kept in structure-of-arrays form: frames where the ball is
+// in open play (the vast majority) are advanced four games at a time, the
+// rest go through StepWorld so the rules are exactly the same as the game.
+// Finished matches reset themselves; nothing allocates after InitBatchEnv.
+
+const int OBSERVATION_SIZE = 6; // Ball x, y, velocity x, y, own paddle y, bot paddle y
+
+struct BatchEnv {
+    int count;
+    Difficulty difficulty;
+
+    // Per-game state
+    std::vector<float> ballX;
+    std::vector<float> ballY;
+    std::vector<float> oldX;
+    std::vector<float> oldY;
+    std::vector<float> playerY;
+    std::vector<float> botY;
+    std::vector<float> futureX;
+    std::vector<float> futureY;
+    std::vector<int32_t> futureCollision;
+    std::vector<float> currentSpeed;
+    std::vector<int32_t> playerScore;
+    std::vector<int32_t> botScore;
+    std::vector<Rng> rng;
+
+    // Outputs of the last StepBatchEnv
+    std::vector<float> observations; // count * OBSERVATION_SIZE, scaled to about [-1, 1]
+    std::vector<float> rewards;      // +1 agent scored, -1 bot scored
+    std::vector<uint8_t> dones;      // Match finished (and was reset)
+};
+
+// EXPERT plays as HARD: the search bot would need a tree and a time budget
+// per game. env.difficulty is the one played.
+void InitBatchEnv(BatchEnv& env, int count, Difficulty difficulty, uint64_t seed);
+void ResetBatchGame(BatchEnv& env, int index);
+void StepBatchEnv(BatchEnv& env, const uint8_t* actions);
+
+// Moving a single game between the batch and a World
+void LoadBatchGame(const BatchEnv& env, int index, World& world);
+void StoreBatchGame(BatchEnv& env, int index, const World& world);
+
+#endif //PONG_BATCH_ENV_H
@@ -0,0 +1,232 @@
+#include "chaos.h"
+#include "profiler.h"
+#include <cmath>
+
+static const double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+// Collisions keep the total energy, but fast balls score and come back at
+// serve speed, so the field would slowly settle; nobody stays below this
+const float CHAOS_MIN_SPEED = 0.5f * CHAOS_BALL_SPEED;
+
+// A new ball somewhere on the center line, heading either way
+static void ServeChaosBall(ChaosWorld& chaos, int i) {
+    float y = (float)RandomValue(chaos.rng, PLAY_AREA_TOP + CHAOS_BALL_RADIUS, PLAY_AREA_BOTTOM - CHAOS_BALL_RADIUS);
+    chaos.balls[i] = {{SCREEN_WIDTH / 2.0f, y}, NO_COL};
+    chaos.velocity[i] = randomDirection(chaos.rng, CHAOS_BALL_SPEED);
+    if (RandomValue(chaos.rng, 0, 1)) chaos.velocity[i].x = -chaos.velocity[i].x;
+}
+
+void InitChaos(ChaosWorld& chaos, int balls, uint64_t seed) {
+    if (balls < 1) balls = 1;
+    if (balls > MAX_CHAOS_BALLS) balls = MAX_CHAOS_BALLS;
+    chaos.count = balls;
+    chaos.balls.assign(balls, Circle{});
+    chaos.velocity.assign(balls, Vector2{});
+    chaos.gridColumns = (SCREEN_WIDTH + CHAOS_CELL_SIZE - 1) / CHAOS_CELL_SIZE;
+    chaos.gridRows = (PLAY_AREA_BOTTOM - PLAY_AREA_TOP + CHAOS_CELL_SIZE - 1) / CHAOS_CELL_SIZE;
+    chaos.ballCell.assign(balls, 0);
+    chaos.cellStart.assign(chaos.gridColumns * chaos.gridRows + 1, 0);
+    chaos.sorted.assign(balls, 0);
+
+    chaos.player = {10, SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f, PADDLE_WIDTH, PADDLE_HEIGHT};
+    chaos.bot = {SCREEN_WIDTH - 30.0f, SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f, PADDLE_WIDTH, PADDLE_HEIGHT};
+    chaos.playerScore = 0;
+    chaos.botScore = 0;
+    chaos.events.count = 0;
+    chaos.stats = {};
+    SeedRng(chaos.rng, seed);
+
+    // Spread out between the paddles; overlaps are pushed apart in a few steps
+    for (int i = 0; i < balls; i++) {
+        chaos.balls[i].center = {(float)RandomValue(chaos.rng, 100, SCREEN_WIDTH - 100),
+                                 (float)RandomValue(chaos.rng, PLAY_AREA_TOP + CHAOS_BALL_RADIUS, PLAY_AREA_BOTTOM - CHAOS_BALL_RADIUS)};
+        chaos.balls[i].Collision = NO_COL;
+        chaos.velocity[i] = randomDirection(chaos.rng, CHAOS_BALL_SPEED);
+        if (RandomValue(chaos.rng, 0, 1)) chaos.velocity[i].x = -chaos.velocity[i].x;
+    }
+}
+
+static int CellOf(const ChaosWorld& chaos, Vector2 center) {
+    int column = (int)(center.x / CHAOS_CELL_SIZE);
+    int row = (int)((center.y - PLAY_AREA_TOP) / CHAOS_CELL_SIZE);
+    if (column < 0) column = 0;
+    if (column >= chaos.gridColumns) column = chaos.gridColumns - 1;
+    if (row < 0) row = 0;
+    if (row >= chaos.gridRows) row = chaos.gridRows - 1;
+    return row * chaos.gridColumns + column;
+}
+
+// Counting sort of the balls by cell
+static void BuildGrid(ChaosWorld& chaos) {
+    int cells = chaos.gridColumns * chaos.gridRows;
+    int* start = chaos.cellStart.data();
+    for (int c = 0; c < cells; c++) start[c] = 0;
+    for (int i = 0; i < chaos.count; i++) {
+        int cell = CellOf(chaos, chaos.balls[i].center);
+        chaos.ballCell[i] = cell;
+        start[cell]++;
+    }
+    // Running totals put each entry at its cell's end; filling back to front
+    // walks it down to the cell's start and keeps balls in ascending order
+    for (int c = 1; c < cells; c++) start[c] += start[c - 1];
+    for (int i = chaos.count - 1; i >= 0; i--) {
+        chaos.sorted[--start[chaos.ballCell[i]]] = i;
+    }
+    start[cells] = chaos.count;
+}
+
+// Equal masses: exchange the velocity components along the contact normal,
+// and move both balls half the overlap apart
+static void ResolvePair(ChaosWorld& chaos, int a, int b) {
+    chaos.stats.pairsTested++;
+    Vector2& pa = chaos.balls[a].center;
+    Vector2& pb = chaos.balls[b].center;
+    float dx = pb.x - pa.x;
+    float dy = pb.y - pa.y;
+    float distanceSq = dx * dx + dy * dy;
+    const float touch = 2.0f * CHAOS_BALL_RADIUS;
+    if (distanceSq >= touch * touch) return;
+    chaos.stats.contacts++;
+
+    float distance = sqrtf(distanceSq);
+    float nx = 1.0f;
+    float ny = 0.0f;
+    if (distance > 0.0f) {
+        nx = dx / distance;
+        ny = dy / distance;
+    }
+    float push = (touch - distance) * 0.5f;
+    pa.x -= nx * push;
+    pa.y -= ny * push;
+    pb.x += nx * push;
+    pb.y += ny * push;
+
+    Vector2& va = chaos.velocity[a];
+    Vector2& vb = chaos.velocity[b];
+    float approach = (vb.x - va.x) * nx + (vb.y - va.y) * ny;
+    if (approach >= 0.0f) return; // Already separating
+    va.x += approach * nx;
+    va.y += approach * ny;
+    vb.x -= approach * nx;
+    vb.y -= approach * ny;
+}
+
+static void CollideBalls(ChaosWorld& chaos) {
+    BuildGrid(chaos);
+    const int* start = chaos.cellStart.data();
+    const int* sorted = chaos.sorted.data();
+
+    // Each pair once: the rest of a ball's own cell, then the four neighbours
+    // ahead of it (right, and the row below). Walking the balls in cell
+    // order instead of the grid skips the empty cells.
+    const int offsets[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+    for (int i = 0; i < chaos.count; i++) {
+        int a = sorted[i];
+        int cell = chaos.ballCell[a];
+        int column = cell % chaos.gridColumns;
+        int row = cell / chaos.gridColumns;
+        for (int j = i + 1; j < start[cell + 1]; j++) ResolvePair(chaos, a, sorted[j]);
+
+        for (const int* offset : offsets) {
+            int c = column + offset[0];
+            int r = row + offset[1];
+            if (c < 0 || c >= chaos.gridColumns || r >= chaos.gridRows) continue;
+            int other = r * chaos.gridColumns + c;
+            for (int j = start[other]; j < start[other + 1]; j++) ResolvePair(chaos, a, sorted[j]);
+        }
+    }
+}
+
+// Same spin as the classic ball: where the paddle is hit sets the angle
+static Vector2 PaddleBounce(Vector2 velocity, float y, Rectangle paddle, bool left) {
+    float speed = sqrtf(velocity.x * velocity.x + velocity.y * velocity.y);
+    float hitPoint = (y - paddle.y) / PADDLE_HEIGHT;
+    if (hitPoint < 0) hitPoint = 0;
+    if (hitPoint > 1) hitPoint = 1;
+    double angle = left ? (-75 + hitPoint * 150) * DEG_TO_RAD : (255 - hitPoint * 150) * DEG_TO_RAD;
+    return {speed * (float)cos(angle), speed * (float)sin(angle)};
+}
+
+static void MoveBalls(ChaosWorld& chaos) {
+    for (int i = 0; i < chaos.count; i++) {
+        Circle& ball = chaos.balls[i];
+        Vector2& velocity = chaos.velocity[i];
+        float speedSq = velocity.x * velocity.x + velocity.y * velocity.y;
+        if (speedSq < CHAOS_MIN_SPEED * CHAOS_MIN_SPEED) {
+            float scale = speedSq > 0.0f ? CHAOS_MIN_SPEED / sqrtf(speedSq) : 0.0f;
+            velocity = speedSq > 0.0f ? Vector2{velocity.x * scale, velocity.y * scale} : Vector2{-CHAOS_MIN_SPEED, 0.0f};
+        }
+
+        Vector2 oldPosition = ball.center;
+        ball.center = ball.center + velocity;
+        CircleCollideWith(ball, oldPosition, chaos.player, chaos.bot, CHAOS_BALL_RADIUS);
+
+        switch (ball.Collision) {
+            case UPPER_BORDER:
+            case LOWER_BORDER: {
+                PushEvent(chaos.events, WALL_HIT, ball.center, ball.center.x < SCREEN_WIDTH / 2.0f ? LEFT_SIDE : RIGHT_SIDE);
+                velocity.y = -velocity.y;
+                if (ball.Collision == UPPER_BORDER) ball.center.y = PLAY_AREA_TOP + CHAOS_BALL_RADIUS + 1;
+                else ball.center.y = PLAY_AREA_BOTTOM - CHAOS_BALL_RADIUS - 1;
+                break;
+            }
+            case PLAYER_COL: {
+                PushEvent(chaos.events, PADDLE_HIT, ball.center, LEFT_SIDE);
+                velocity = PaddleBounce(velocity, ball.center.y, chaos.player, true);
+                ball.center.x = chaos.player.x + PADDLE_WIDTH + CHAOS_BALL_RADIUS + 1;
+                break;
+            }
+            case BOT_COL: {
+                PushEvent(chaos.events, PADDLE_HIT, ball.center, RIGHT_SIDE);
+                velocity = PaddleBounce(velocity, ball.center.y, chaos.bot, false);
+                ball.center.x = chaos.bot.x - CHAOS_BALL_RADIUS - 1;
+                break;
+            }
+            case LEFT_BORDER: {
+                chaos.botScore++;
+                PushEvent(chaos.events, SCORE, ball.center, RIGHT_SIDE);
+                ServeChaosBall(chaos, i);
+                break;
+            }
+            case RIGHT_BORDER: {
+                chaos.playerScore++;
+                PushEvent(chaos.events, SCORE, ball.center, LEFT_SIDE);
+                ServeChaosBall(chaos, i);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+// The bot goes for whichever ball reaches its paddle first
+static void MoveChaosBot(ChaosWorld& chaos) {
+    float bestTime = 0.0f;
+    int best = -1;
+    for (int i = 0; i < chaos.count; i++) {
+        float vx = chaos.velocity[i].x;
+        if (vx <= 0.0f) continue;
+        float time = (chaos.bot.x - chaos.balls[i].center.x) / vx;
+        if (time < 0.0f) continue;
+        if (best < 0 || time < bestTime) {
+            bestTime = time;
+            best = i;
+        }
+    }
+    if (best >= 0) moveBotEasy(chaos.bot, chaos.balls[best].center);
+}
+
+void StepChaos(ChaosWorld& chaos, uint8_t input) {
+    chaos.events.count = 0;
+    chaos.stats = {};
+    MovePaddle(chaos.player, input);
+
+    {
+        PROFILE_ZONE(ZONE_BALL);
+        CollideBalls(chaos);
+        MoveBalls(chaos);
+    }
+    PROFILE_ZONE(ZONE_BOT);
+    MoveChaosBot(chaos);
+}
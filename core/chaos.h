@@ -0,0 +1,52 @@
+#ifndef PONG_CHAOS_H
+#define PONG_CHAOS_H
+
+#include <vector>
+#include "core.h"
+
+// Chaos mode
+// Hundreds to thousands of small balls on the normal field and paddles.
+// Balls bounce off each other elastically (equal masses); candidate pairs
+// come from a uniform grid of cells one ball across, rebuilt every step with
+// a counting sort, so only balls in neighbouring cells are ever compared.
+// Walls and paddles go through CircleCollideWith like the classic ball.
+
+const int CHAOS_BALL_RADIUS = 6;
+const int CHAOS_CELL_SIZE = 2 * CHAOS_BALL_RADIUS; // Touching balls are at most one cell apart
+const int DEFAULT_CHAOS_BALLS = 1000;
+const int MAX_CHAOS_BALLS = 8192;
+const float CHAOS_BALL_SPEED = 4.0f;
+
+struct ChaosStats {
+    long pairsTested; // Narrow phase distance checks in the last step
+    long contacts;    // Of those, pairs that were touching
+};
+
+struct ChaosWorld {
+    int count;
+    std::vector<Circle> balls;
+    std::vector<Vector2> velocity;
+
+    // Broad phase, sized once so a step never allocates
+    int gridColumns;
+    int gridRows;
+    std::vector<int> ballCell;
+    std::vector<int> cellStart; // Balls of cell c are sorted[cellStart[c] .. cellStart[c + 1])
+    std::vector<int> sorted;
+
+    Rectangle player;
+    Rectangle bot;
+    int playerScore;
+    int botScore;
+    Rng rng;
+    EventList events; // Filled by the last StepChaos, first MAX_EVENTS only
+    ChaosStats stats;
+};
+
+void InitChaos(ChaosWorld& chaos, int balls, uint64_t seed);
+
+// Player input on the left paddle, a bot chasing the next ball on the right.
+// A ball past either side scores and comes back on the center line.
+void StepChaos(ChaosWorld& chaos, uint8_t input);
+
+#endif //PONG_CHAOS_H
@@ -0,0 +1,678 @@
+#include "core.h"
+#include "fixed.h"
+#include "predict.h"
+#include "profiler.h"
+#include <cmath>
+
+static const double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+// Random numbers (splitmix64)
+void SeedRng(Rng& rng, uint64_t seed) {
+    rng.state = seed;
+}
+
+uint64_t RandomBits(Rng& rng) {
+    uint64_t z = (rng.state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+int RandomValue(Rng& rng, int min, int max) {
+    if (min > max) {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+    uint64_t range = (uint64_t)((int64_t)max - min) + 1;
+    return min + (int)(RandomBits(rng) % range);
+}
+
+void PushEvent(EventList& events, EventType type, Vector2 position, Side side) {
+    if (events.count < MAX_EVENTS) {
+        events.items[events.count++] = {type, position, side};
+    }
+}
+
+// Collision detection
+bool CircleOverlapsRect(Vector2 center, float radius, Rectangle rec) {
+#ifdef PONG_FIXED_POINT
+    // Twice every distance, so the paddle's half sizes stay whole
+    int64_t width = ToFixed(rec.width);
+    int64_t height = ToFixed(rec.height);
+    int64_t reach = 2 * (int64_t)ToFixed(radius);
+    int64_t dx = 2 * (int64_t)ToFixed(center.x) - (2 * (int64_t)ToFixed(rec.x) + width);
+    int64_t dy = 2 * (int64_t)ToFixed(center.y) - (2 * (int64_t)ToFixed(rec.y) + height);
+    if (dx < 0) dx = -dx;
+    if (dy < 0) dy = -dy;
+
+    if (dx > width + reach) return false;
+    if (dy > height + reach) return false;
+    if (dx <= width) return true;
+    if (dy <= height) return true;
+
+    int64_t cornerX = dx - width;
+    int64_t cornerY = dy - height;
+    return cornerX * cornerX + cornerY * cornerY <= reach * reach;
+#else
+    float halfWidth = rec.width / 2.0f;
+    float halfHeight = rec.height / 2.0f;
+    float dx = fabsf(center.x - (rec.x + halfWidth));
+    float dy = fabsf(center.y - (rec.y + halfHeight));
+
+    if (dx > halfWidth + radius) return false;
+    if (dy > halfHeight + radius) return false;
+    if (dx <= halfWidth) return true;
+    if (dy <= halfHeight) return true;
+
+    float cornerDistanceSq = (dx - halfWidth) * (dx - halfWidth) + (dy - halfHeight) * (dy - halfHeight);
+    return cornerDistanceSq <= radius * radius;
+#endif
+}
+
+#ifdef PONG_FIXED_POINT
+// Times of impact are fractions of the segment with TIME_BITS fraction bits
+const int TIME_BITS = 16;
+const int64_t TIME_ONE = 1 << TIME_BITS;
+
+static bool SegmentEntersBoxFixed(const int64_t start[2], const int64_t dir[2], const int64_t lo[2],
+                                  const int64_t hi[2], int64_t& t) {
+    int64_t tMin = 0;
+    int64_t tMax = TIME_ONE;
+    for (int axis = 0; axis < 2; axis++) {
+        if (dir[axis] == 0) {
+            if (start[axis] < lo[axis] || start[axis] > hi[axis]) return false;
+            continue;
+        }
+        int64_t t1 = (lo[axis] - start[axis]) * TIME_ONE / dir[axis];
+        int64_t t2 = (hi[axis] - start[axis]) * TIME_ONE / dir[axis];
+        if (t1 > t2) { int64_t tmp = t1; t1 = t2; t2 = tmp; }
+        if (t1 > tMin) tMin = t1;
+        if (t2 < tMax) tMax = t2;
+        if (tMin > tMax) return false;
+    }
+    t = tMin;
+    return true;
+}
+
+// Corner circles work at 1/16 pixel: the products would overflow at full precision
+static bool SegmentEntersCircleFixed(const int64_t from[2], const int64_t d[2], const int64_t center[2],
+                                     int64_t radius, int64_t& t) {
+    const int DROP = FIXED_BITS - 4;
+    int64_t mx = (from[0] - center[0]) >> DROP;
+    int64_t my = (from[1] - center[1]) >> DROP;
+    int64_t dx = d[0] >> DROP;
+    int64_t dy = d[1] >> DROP;
+    int64_t r = radius >> DROP;
+
+    int64_t c = mx * mx + my * my - r * r;
+    if (c <= 0) { t = 0; return true; }
+
+    int64_t a = dx * dx + dy * dy;
+    int64_t b = mx * dx + my * dy;
+    if (a == 0 || b >= 0) return false; // Not moving, or moving away
+    int64_t disc = b * b - a * c;
+    if (disc < 0) return false;
+
+    int64_t hit = (-b - (int64_t)IntSqrt((uint64_t)disc)) * TIME_ONE / a;
+    if (hit > TIME_ONE) return false;
+    t = hit;
+    return true;
+}
+
+static bool SweepCircleRectFixed(Vector2 from, Vector2 to, float radius, Rectangle rec, float& t) {
+    int64_t start[2] = {ToFixed(from.x), ToFixed(from.y)};
+    int64_t d[2] = {ToFixed(to.x) - start[0], ToFixed(to.y) - start[1]};
+    int64_t r = ToFixed(radius);
+    int64_t left = ToFixed(rec.x);
+    int64_t top = ToFixed(rec.y);
+    int64_t right = left + ToFixed(rec.width);
+    int64_t bottom = top + ToFixed(rec.height);
+    int64_t best = 2 * TIME_ONE;
+    int64_t hit;
+
+    int64_t wideLo[2] = {left - r, top};
+    int64_t wideHi[2] = {right + r, bottom};
+    if (SegmentEntersBoxFixed(start, d, wideLo, wideHi, hit) && hit < best) best = hit;
+    int64_t tallLo[2] = {left, top - r};
+    int64_t tallHi[2] = {right, bottom + r};
+    if (SegmentEntersBoxFixed(start, d, tallLo, tallHi, hit) && hit < best) best = hit;
+
+    int64_t corners[4][2] = {{left, top}, {right, top}, {left, bottom}, {right, bottom}};
+    for (const int64_t* corner : corners) {
+        if (SegmentEntersCircleFixed(start, d, corner, r, hit) && hit < best) best = hit;
+    }
+
+    if (best > TIME_ONE) return false;
+    t = (float)best / TIME_ONE; // Exact
+    return true;
+}
+#else
+
+// Entry time of the segment from + t * d, t in [0, 1], into a box
+static bool SegmentEntersBox(Vector2 from, Vector2 d, float minX, float minY, float maxX, float maxY, float& t) {
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    float start[2] = {from.x, from.y};
+    float dir[2] = {d.x, d.y};
+    float lo[2] = {minX, minY};
+    float hi[2] = {maxX, maxY};
+
+    for (int axis = 0; axis < 2; axis++) {
+        if (dir[axis] == 0.0f) {
+            if (start[axis] < lo[axis] || start[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t1 = (lo[axis] - start[axis]) / dir[axis];
+        float t2 = (hi[axis] - start[axis]) / dir[axis];
+        if (t1 > t2) { float tmp = t1; t1 = t2; t2 = tmp; }
+        if (t1 > tMin) tMin = t1;
+        if (t2 < tMax) tMax = t2;
+        if (tMin > tMax) return false;
+    }
+    t = tMin;
+    return true;
+}
+
+// Entry time of the segment from + t * d, t in [0, 1], into a circle
+static bool SegmentEntersCircle(Vector2 from, Vector2 d, Vector2 center, float radius, float& t) {
+    Vector2 m = from - center;
+    float c = m.x * m.x + m.y * m.y - radius * radius;
+    if (c <= 0.0f) { t = 0.0f; return true; }
+
+    float a = d.x * d.x + d.y * d.y;
+    float b = m.x * d.x + m.y * d.y;
+    if (a == 0.0f || b >= 0.0f) return false; // Not moving, or moving away
+    float disc = b * b - a * c;
+    if (disc < 0.0f) return false;
+
+    float hit = (-b - sqrtf(disc)) / a;
+    if (hit > 1.0f) return false;
+    t = hit;
+    return true;
+}
+#endif
+
+// Earliest time of impact of a ball moving from -> to against a paddle. The
+// ball's center touches the paddle exactly when it enters the paddle grown
+// by the radius: two stretched boxes plus a circle on every corner.
+bool SweepCircleRect(Vector2 from, Vector2 to, float radius, Rectangle rec, float& t) {
+    // Cheap reject: the swept bounds miss the grown paddle entirely
+    if (fminf(from.x, to.x) > rec.x + rec.width + radius || fmaxf(from.x, to.x) < rec.x - radius) return false;
+    if (fminf(from.y, to.y) > rec.y + rec.height + radius || fmaxf(from.y, to.y) < rec.y - radius) return false;
+
+#ifdef PONG_FIXED_POINT
+    return SweepCircleRectFixed(from, to, radius, rec, t);
+#else
+    Vector2 d = to - from;
+    float best = 2.0f;
+    float hit;
+
+    if (SegmentEntersBox(from, d, rec.x - radius, rec.y, rec.x + rec.width + radius, rec.y + rec.height, hit) && hit < best) best = hit;
+    if (SegmentEntersBox(from, d, rec.x, rec.y - radius, rec.x + rec.width, rec.y + rec.height + radius, hit) && hit < best) best = hit;
+
+    Vector2 corners[4] = {
+        {rec.x, rec.y},
+        {rec.x + rec.width, rec.y},
+        {rec.x, rec.y + rec.height},
+        {rec.x + rec.width, rec.y + rec.height},
+    };
+    for (Vector2 corner : corners) {
+        if (SegmentEntersCircle(from, d, corner, radius, hit) && hit < best) best = hit;
+    }
+
+    if (best > 1.0f) return false;
+    t = best;
+    return true;
+#endif
+}
+
+void CircleCollideWith(Circle& circle, Rectangle player, Rectangle bot, float radius) {
+    if (circle.center.x < radius) { circle.Collision = LEFT_BORDER; return; }
+    if (circle.center.x > SCREEN_WIDTH - radius) { circle.Collision = RIGHT_BORDER; return; }
+    if (circle.center.y < PLAY_AREA_TOP + radius) { circle.Collision = UPPER_BORDER; return; }
+    if (circle.center.y > PLAY_AREA_BOTTOM - radius) { circle.Collision = LOWER_BORDER; return; }
+    if (CircleOverlapsRect(circle.center, radius, player)) { circle.Collision = PLAYER_COL; return; }
+    if (CircleOverlapsRect(circle.center, radius, bot)) { circle.Collision = BOT_COL; return; }
+    circle.Collision = NO_COL;
+}
+
+// Continuous version: also catches a ball that went through a paddle since
+// oldPosition and moves it back to the point of impact
+void CircleCollideWith(Circle& circle, Vector2 oldPosition, Rectangle player, Rectangle bot, float radius) {
+    float hitTime;
+    CircleCollideWith(circle, oldPosition, player, bot, radius, hitTime);
+}
+
+void CircleCollideWith(Circle& circle, Vector2 oldPosition, Rectangle player, Rectangle bot, float radius, float& hitTime) {
+    hitTime = 0.0f;
+    CircleCollideWith(circle, player, bot, radius);
+    if (circle.Collision == PLAYER_COL || circle.Collision == BOT_COL) return;
+    if (oldPosition == circle.center) return;
+
+    float tPlayer = 2.0f;
+    float tBot = 2.0f;
+    SweepCircleRect(oldPosition, circle.center, radius, player, tPlayer);
+    SweepCircleRect(oldPosition, circle.center, radius, bot, tBot);
+    float t = tPlayer < tBot ? tPlayer : tBot;
+    if (t > 1.0f) return;
+
+    // A wall crossed before the paddle is reached still wins
+    Vector2 Velocity = circle.center - oldPosition;
+#ifdef PONG_FIXED_POINT
+    int64_t time = (int64_t)(t * TIME_ONE);
+    if (circle.Collision == UPPER_BORDER || circle.Collision == LOWER_BORDER) {
+        float limit = circle.Collision == UPPER_BORDER ? PLAY_AREA_TOP + radius : PLAY_AREA_BOTTOM - radius;
+        int64_t vy = ToFixed(Velocity.y);
+        int64_t tWall = vy != 0 ? (int64_t)ToFixed(limit - oldPosition.y) * TIME_ONE / vy : 0;
+        if (tWall <= time) return;
+    }
+
+    Fixed x = ToFixed(oldPosition.x) + (Fixed)(((int64_t)ToFixed(Velocity.x) * time) >> TIME_BITS);
+    Fixed y = ToFixed(oldPosition.y) + (Fixed)(((int64_t)ToFixed(Velocity.y) * time) >> TIME_BITS);
+    circle.center = {FromFixed(x), FromFixed(y)};
+    hitTime = (float)time / TIME_ONE; // Exact
+#else
+    if (circle.Collision == UPPER_BORDER || circle.Collision == LOWER_BORDER) {
+        float limit = circle.Collision == UPPER_BORDER ? PLAY_AREA_TOP + radius : PLAY_AREA_BOTTOM - radius;
+        float tWall = Velocity.y != 0.0f ? (limit - oldPosition.y) / Velocity.y : 0.0f;
+        if (tWall <= t) return;
+    }
+
+    circle.center = {oldPosition.x + Velocity.x * t, oldPosition.y + Velocity.y * t};
+    hitTime = t;
+#endif
+    circle.Collision = tPlayer < tBot ? PLAYER_COL : BOT_COL;
+}
+
+void CircleCollideWith(Circle& circle) {
+    if (circle.center.x < BALL_RADIUS) { circle.Collision = LEFT_BORDER; return; }
+    if (circle.center.x > SCREEN_WIDTH - BALL_RADIUS) { circle.Collision = RIGHT_BORDER; return; }
+    if (circle.center.y < PLAY_AREA_TOP + BALL_RADIUS) { circle.Collision = UPPER_BORDER; return; }
+    if (circle.center.y > PLAY_AREA_BOTTOM - BALL_RADIUS) { circle.Collision = LOWER_BORDER; return; }
+    circle.Collision = NO_COL;
+}
+
+Vector2 randomDirection(Rng& rng, float dep) {
+    int x = RandomValue(rng, 120, 240);
+#ifdef PONG_FIXED_POINT
+    Fixed vx;
+    Fixed vy;
+    FixedPolar(ToFixed(dep), x * ANGLE_STEPS, vx, vy);
+    return {FromFixed(vx), FromFixed(vy)};
+#else
+    double deg = (double)x * DEG_TO_RAD;
+    return {dep * (float)cos(deg), dep * (float)sin(deg)};
+#endif
+}
+
+bool withinHigh(Rectangle rec) {
+    return rec.y > PLAY_AREA_TOP;
+}
+
+bool withinLow(Rectangle rec) {
+    return (rec.y + rec.height) < PLAY_AREA_BOTTOM;
+}
+
+Circle PointOfCollision(Circle circle, Vector2 oldPosition) {
+    Vector2 Velocity = circle.center - oldPosition;
+    CircleCollideWith(circle);
+    if (Velocity.x == 0 && Velocity.y == 0) return circle; // Would never get anywhere
+    while (circle.Collision == NO_COL) {
+        circle.center = circle.center + Velocity;
+        CircleCollideWith(circle);
+    }
+    return circle;
+}
+
+void IncreaseSpeed(Circle circle, Vector2& Velocity, float& currentSpeed, float stepFraction) {
+    if (circle.Collision == PLAYER_COL || circle.Collision == BOT_COL) {
+#ifdef PONG_FIXED_POINT
+        int64_t vx = ToFixed(Velocity.x);
+        int64_t vy = ToFixed(Velocity.y);
+        int64_t speed = (int64_t)IntSqrt((uint64_t)(vx * vx + vy * vy));
+        if (speed == 0) speed = 1;
+        Fixed increase = FixedDiv(2 * FIXED_ONE, ToFixed(currentSpeed));
+        int64_t step = FixedMul(increase, ToFixed(stepFraction));
+        Velocity.x += FromFixed((Fixed)(step * vx / speed));
+        Velocity.y += FromFixed((Fixed)(step * vy / speed));
+        currentSpeed += FromFixed(increase);
+#else
+        float speed = sqrt(pow(Velocity.x, 2) + pow(Velocity.y, 2));
+        float increase = 2.0f / currentSpeed; // Logarithmic increase
+        Velocity.x += (increase * stepFraction * Velocity.x) / speed;
+        Velocity.y += (increase * stepFraction * Velocity.y) / speed;
+        currentSpeed += increase;
+#endif
+    }
+}
+
+Circle RightBorderCollision(Circle circle, Vector2 oldPosition) {
+    Circle futureCollision = PointOfCollision(circle, oldPosition);
+    Vector2 Velocity = circle.center - oldPosition;
+    int bounceCount = 0;
+    while (futureCollision.Collision != RIGHT_BORDER && bounceCount < 10) {
+        if (futureCollision.Collision == UPPER_BORDER || futureCollision.Collision == LOWER_BORDER) {
+            Velocity.y = -Velocity.y;
+            futureCollision = PointOfCollision({futureCollision.center + Velocity, NO_COL}, futureCollision.center);
+            bounceCount++;
+        } else {
+            break;
+        }
+    }
+    return futureCollision;
+}
+
+#ifdef PONG_FIXED_POINT
+// Same speed, new angle: firstAngle at the paddle's top edge, then
+// direction * 150 degrees across its height, as move() does in floats
+static Vector2 DeflectFixed(Vector2 velocity, float dif, int firstAngle, int direction) {
+    int64_t vx = ToFixed(velocity.x);
+    int64_t vy = ToFixed(velocity.y);
+    Fixed speed = (Fixed)IntSqrt((uint64_t)(vx * vx + vy * vy));
+    int64_t hit = ToFixed(dif);
+    if (hit < 0) hit = 0;
+    if (hit > PADDLE_HEIGHT * FIXED_ONE) hit = PADDLE_HEIGHT * FIXED_ONE;
+    int angle = firstAngle * ANGLE_STEPS + direction * (int)(hit * 150 * ANGLE_STEPS / (PADDLE_HEIGHT * FIXED_ONE));
+
+    Fixed x;
+    Fixed y;
+    FixedPolar(speed, angle, x, y);
+    return {FromFixed(x), FromFixed(y)};
+}
+#endif
+
+int move(Circle& circle, Vector2& OldPosition, float dep, Rectangle player, Rectangle bot, float& currentSpeed,
+         Rng& rng, EventList& events, float stepFraction) {
+    int score = 0;
+    Vector2 Velocity;
+
+    if (OldPosition == circle.center) {
+        Velocity = randomDirection(rng, dep * stepFraction);
+        OldPosition = circle.center;
+        circle.center = circle.center + Velocity;
+        return 0;
+    }
+
+    // A swept hit moves the ball back along its path; the bounce still
+    // keeps the whole step's speed and spends what's left of the step
+    Vector2 stepVelocity = circle.center - OldPosition;
+    float hitTime;
+    CircleCollideWith(circle, OldPosition, player, bot, BALL_RADIUS, hitTime);
+
+    switch (circle.Collision) {
+        case NO_COL: {
+            Velocity = circle.center - OldPosition;
+            break;
+        }
+        case UPPER_BORDER:
+        case LOWER_BORDER: {
+            PushEvent(events, WALL_HIT, circle.center, circle.center.x < SCREEN_WIDTH / 2.0f ? LEFT_SIDE : RIGHT_SIDE);
+            Velocity.x = circle.center.x - OldPosition.x;
+            Velocity.y = OldPosition.y - circle.center.y;
+
+            // Push ball away from border
+            if (circle.Collision == UPPER_BORDER) circle.center.y = PLAY_AREA_TOP + BALL_RADIUS + 2;
+            else circle.center.y = PLAY_AREA_BOTTOM - BALL_RADIUS - 2;
+            break;
+        }
+        case BOT_COL: {
+            PushEvent(events, PADDLE_HIT, circle.center, RIGHT_SIDE);
+            Velocity = stepVelocity;
+#ifdef PONG_FIXED_POINT
+            Velocity = DeflectFixed(Velocity, circle.center.y - bot.y, 255, -1);
+#else
+            float speed = sqrt(pow(Velocity.x, 2) + pow(Velocity.y, 2));
+            float dif = circle.center.y - bot.y;
+            float hitPoint = dif / PADDLE_HEIGHT;
+            if (hitPoint < 0) hitPoint = 0;
+            if (hitPoint > 1) hitPoint = 1;
+            // FIXED: Y grows DOWN, so angles need to be inverted
+            // hitPoint 0 (top) should send ball UP (negative Y velocity)
+            // hitPoint 1 (bottom) should send ball DOWN (positive Y velocity)
+            double angle = (255 - (hitPoint * 150)) * DEG_TO_RAD; // Inverted from 255° to 105°
+            Velocity.x = speed * (float)cos(angle);
+            Velocity.y = speed * (float)sin(angle);
+#endif
+
+            // Push ball away from paddle to prevent multi-collision
+            circle.center.x = bot.x - BALL_RADIUS - 2;
+
+            score = 1;
+            break;
+        }
+        case PLAYER_COL: {
+            PushEvent(events, PADDLE_HIT, circle.center, LEFT_SIDE);
+            Velocity = stepVelocity;
+#ifdef PONG_FIXED_POINT
+            Velocity = DeflectFixed(Velocity, circle.center.y - player.y, -75, 1);
+#else
+            float speed = sqrt(pow(Velocity.x, 2) + pow(Velocity.y, 2));
+            float dif = circle.center.y - player.y;
+            float hitPoint = dif / PADDLE_HEIGHT;
+            if (hitPoint < 0) hitPoint = 0;
+            if (hitPoint > 1) hitPoint = 1;
+            // FIXED: Y grows DOWN, so angles need to be inverted
+            // hitPoint 0 (top) should send ball UP (negative Y velocity)
+            // hitPoint 1 (bottom) should send ball DOWN (positive Y velocity)
+            double angle = (-75 + (hitPoint * 150)) * DEG_TO_RAD; // From -75° to 75°
+            Velocity.x = speed * (float)cos(angle);
+            Velocity.y = speed * (float)sin(angle);
+#endif
+
+            // Push ball away from paddle
+            circle.center.x = player.x + PADDLE_WIDTH + BALL_RADIUS + 2;
+
+            score = 1;
+            break;
+        }
+        default: {
+            // Left/right border: scoring is handled by StepWorld before we get here
+            Velocity = circle.center - OldPosition;
+            break;
+        }
+    }
+
+    IncreaseSpeed(circle, Velocity, currentSpeed, stepFraction);
+    OldPosition = circle.center;
+    circle.center = circle.center + Velocity;
+    if (hitTime > 0.0f) {
+        // Only the rest of the step after the hit; OldPosition stays a whole
+        // step back so the speed reads the same next step
+#ifdef PONG_FIXED_POINT
+        int64_t left = TIME_ONE - (int64_t)(hitTime * TIME_ONE);
+        Vector2 rest = {FromFixed((Fixed)((ToFixed(Velocity.x) * left) >> TIME_BITS)),
+                        FromFixed((Fixed)((ToFixed(Velocity.y) * left) >> TIME_BITS))};
+#else
+        Vector2 rest = {Velocity.x * (1.0f - hitTime), Velocity.y * (1.0f - hitTime)};
+#endif
+        circle.center = OldPosition + rest;
+        OldPosition = circle.center - Velocity;
+    }
+    return score;
+}
+
+void moveBotEasy(Rectangle& bot, Vector2 circle) {
+    float botCenterLine = bot.y + PADDLE_HEIGHT / 2;
+    if ((circle.y > botCenterLine) && withinLow(bot)) {
+        bot.y += 5;
+    }
+    if (circle.y < botCenterLine && withinHigh(bot)) {
+        bot.y -= 5;
+    }
+}
+
+void moveBotMedium(Rectangle& bot, Circle circle, Vector2 oldPosition, Circle& futureCollision) {
+    if (circle.Collision == PLAYER_COL || circle.Collision == UPPER_BORDER || circle.Collision == LOWER_BORDER) {
+        futureCollision = PredictCollision(circle, oldPosition);
+    }
+
+    if (futureCollision.Collision != RIGHT_BORDER) {
+        moveBotEasy(bot, circle.center);
+    } else {
+        float botCenterLine = bot.y + PADDLE_HEIGHT / 2;
+        if ((futureCollision.center.y > botCenterLine) && withinLow(bot)) {
+            bot.y += 5;
+        }
+        if (futureCollision.center.y < botCenterLine && withinHigh(bot)) {
+            bot.y -= 5;
+        }
+    }
+}
+
+void moveBotHard(Rectangle& bot, Circle circle, Vector2 oldPosition, Circle& futureCollision) {
+    if (circle.Collision == PLAYER_COL) {
+        Intercept intercept = PredictRightIntercept(circle.center, circle.center - oldPosition);
+        if (intercept.valid) {
+            futureCollision = {{SCREEN_WIDTH - BALL_RADIUS, intercept.y}, RIGHT_BORDER};
+        }
+    }
+    float botCenterLine = bot.y + PADDLE_HEIGHT / 2;
+    if ((futureCollision.center.y > botCenterLine) && withinLow(bot)) {
+        bot.y += 7;
+    }
+    if (futureCollision.center.y < botCenterLine && withinHigh(bot)) {
+        bot.y -= 7;
+    }
+}
+
+static void moveBotEasyAdapter(Rectangle& bot, Circle circle, Vector2, Circle&) {
+    moveBotEasy(bot, circle.center);
+}
+
+BotFunction BotForDifficulty(Difficulty difficulty) {
+    if (difficulty == EASY) return moveBotEasyAdapter;
+    if (difficulty == MEDIUM) return moveBotMedium;
+    return moveBotHard;
+}
+
+Vector2 MirrorPoint(Vector2 point) {
+    return {SCREEN_WIDTH - point.x, point.y};
+}
+
+Rectangle MirrorRect(Rectangle rec) {
+    return {SCREEN_WIDTH - rec.x - rec.width, rec.y, rec.width, rec.height};
+}
+
+Circle MirrorCircle(Circle circle) {
+    Collisions collision = circle.Collision;
+    switch (collision) {
+        case LEFT_BORDER: collision = RIGHT_BORDER; break;
+        case RIGHT_BORDER: collision = LEFT_BORDER; break;
+        case PLAYER_COL: collision = BOT_COL; break;
+        case BOT_COL: collision = PLAYER_COL; break;
+        default: break;
+    }
+    return {MirrorPoint(circle.center), collision};
+}
+
+// Match
+void ResetBall(World& world) {
+    world.circle = {{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, NO_COL};
+    world.OldPosition = world.circle.center;
+    world.currentSpeed = BALL_SPEED;
+}
+
+void ResetWorld(World& world, Difficulty difficulty, uint64_t seed) {
+    world = {};
+    ResetBall(world);
+    world.futureCollision = world.circle;
+    world.playerFuture = MirrorCircle(world.circle);
+    world.player = {10, SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f, PADDLE_WIDTH, PADDLE_HEIGHT};
+    world.bot = {SCREEN_WIDTH - 30.0f, SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f, PADDLE_WIDTH, PADDLE_HEIGHT};
+    world.difficulty = difficulty;
+    world.subSteps = 1;
+    SeedRng(world.rng, seed);
+}
+
+// Scoring and ball movement for one frame
+static void StepBall(World& world) {
+    // Sub-steps move the ball in equal parts of its per-frame velocity
+    int subSteps = world.subSteps > 1 ? world.subSteps : 1;
+    float fraction = 1.0f / subSteps;
+    Vector2 Velocity = world.circle.center - world.OldPosition;
+    if (subSteps > 1) {
+#ifdef PONG_FIXED_POINT
+        Vector2 part = {FromFixed(ToFixed(Velocity.x) / subSteps), FromFixed(ToFixed(Velocity.y) / subSteps)};
+        world.OldPosition = world.circle.center - part;
+#else
+        world.OldPosition = {world.circle.center.x - Velocity.x * fraction, world.circle.center.y - Velocity.y * fraction};
+#endif
+    }
+
+    Collisions frameCollision = NO_COL;
+    for (int step = 0; step < subSteps; step++) {
+        // Check for scoring BEFORE moving. On a copy: a swept paddle hit
+        // moves the ball back, and move() has to see the whole step.
+        Circle check = world.circle;
+        CircleCollideWith(check, world.OldPosition, world.player, world.bot);
+        world.circle.Collision = check.Collision;
+        if (world.circle.Collision == LEFT_BORDER) {
+            world.botScore++;
+            PushEvent(world.events, SCORE, world.circle.center, RIGHT_SIDE);
+            ResetBall(world);
+        }
+        if (world.circle.Collision == RIGHT_BORDER) {
+            world.playerScore++;
+            PushEvent(world.events, SCORE, world.circle.center, LEFT_SIDE);
+            ResetBall(world);
+        }
+
+        // Game logic
+        move(world.circle, world.OldPosition, BALL_SPEED, world.player, world.bot, world.currentSpeed,
+             world.rng, world.events, fraction);
+        if (world.circle.Collision != NO_COL) frameCollision = world.circle.Collision;
+    }
+
+    // Back to per-frame velocity; the bots react to any hit during the frame
+    if (subSteps > 1) {
+        Velocity = world.circle.center - world.OldPosition;
+        world.OldPosition = {world.circle.center.x - Velocity.x * subSteps, world.circle.center.y - Velocity.y * subSteps};
+    }
+    world.circle.Collision = frameCollision;
+}
+
+// Player controls
+void MovePaddle(Rectangle& paddle, uint8_t input) {
+    if ((input & INPUT_UP) && withinHigh(paddle)) {
+        paddle.y -= PLAYER_SPEED;
+    }
+    if ((input & INPUT_DOWN) && withinLow(paddle)) {
+        paddle.y += PLAYER_SPEED;
+    }
+}
+
+void StepWorld(World& world, uint8_t input) {
+    world.events.count = 0;
+    MovePaddle(world.player, input);
+
+    {
+        PROFILE_ZONE(ZONE_BALL);
+        StepBall(world);
+    }
+    PROFILE_ZONE(ZONE_BOT);
+    if (world.difficulty == EXPERT) MovePaddle(world.bot, input >> BOT_INPUT_SHIFT);
+    else BotForDifficulty(world.difficulty)(world.bot, world.circle, world.OldPosition, world.futureCollision);
+}
+
+void StepWorldBots(World& world, BotFunction left, BotFunction right) {
+    world.events.count = 0;
+    StepBall(world);
+    right(world.bot, world.circle, world.OldPosition, world.futureCollision);
+
+    // The left bot plays in a mirrored world
+    Rectangle paddle = MirrorRect(world.player);
+    left(paddle, MirrorCircle(world.circle), MirrorPoint(world.OldPosition), world.playerFuture);
+    world.player.y = paddle.y;
+}
+
+void StepWorldPlayers(World& world, uint8_t left, uint8_t right) {
+    world.events.count = 0;
+    MovePaddle(world.player, left);
+    MovePaddle(world.bot, right);
+    StepBall(world);
+}
+
+bool IsMatchOver(const World& world) {
+    return world.playerScore >= WIN_SCORE || world.botScore >= WIN_SCORE;
+}
@@ -0,0 +1,157 @@
+#ifndef PONG_CORE_H
+#define PONG_CORE_H
+
+#include <cstdint>
+#include "types.h"
+
+// Headless game rules. Nothing in here talks to raylib, the window or the
+// audio device, so a match can be stepped on any machine.
+
+// Constants
+const int SCREEN_WIDTH = 1600;
+const int SCREEN_HEIGHT = 900;
+const int BORDER_THICKNESS = 40; // Decorative border
+const int PLAY_AREA_TOP = BORDER_THICKNESS;
+const int PLAY_AREA_BOTTOM = SCREEN_HEIGHT - BORDER_THICKNESS;
+const int PADDLE_WIDTH = 20;
+const int PADDLE_HEIGHT = 200;
+const int BALL_RADIUS = 20;
+const float BALL_SPEED = 4.0f;
+const int WIN_SCORE = 10;
+const int PLAYER_SPEED = 7;
+const int SIM_HZ = 120; // Steps per second; every speed above is per step
+
+enum Collisions {
+    NO_COL,
+    LOWER_BORDER,
+    UPPER_BORDER,
+    LEFT_BORDER,
+    RIGHT_BORDER,
+    PLAYER_COL,
+    BOT_COL,
+};
+
+enum Difficulty {
+    EASY,
+    MEDIUM,
+    HARD,
+    EXPERT, // Search bot (search_bot.h), steered through the INPUT_BOT_* bits
+};
+
+struct Circle {
+    Vector2 center;
+    Collisions Collision;
+};
+
+// Random numbers - every match owns its generator, so seeding it is enough
+// to reproduce a game (raylib's GetRandomValue is global and not ours)
+struct Rng {
+    uint64_t state;
+};
+
+void SeedRng(Rng& rng, uint64_t seed);
+uint64_t RandomBits(Rng& rng);
+int RandomValue(Rng& rng, int min, int max); // Inclusive, like GetRandomValue
+
+// Events - the front-end turns these into sounds and particles
+enum EventType {
+    WALL_HIT,
+    PADDLE_HIT,
+    SCORE,
+};
+
+enum Side {
+    LEFT_SIDE,  // Player
+    RIGHT_SIDE, // Bot
+};
+
+struct GameEvent {
+    EventType type;
+    Vector2 position;
+    Side side; // Paddle that was hit, or who scored
+};
+
+const int MAX_EVENTS = 8;
+
+struct EventList {
+    GameEvent items[MAX_EVENTS];
+    int count;
+};
+
+void PushEvent(EventList& events, EventType type, Vector2 position, Side side);
+
+// Player input bits for one frame
+enum InputBits : uint8_t {
+    INPUT_UP = 1 << 0,
+    INPUT_DOWN = 1 << 1,
+    INPUT_BOT_UP = 1 << 2,   // Right paddle of an EXPERT world
+    INPUT_BOT_DOWN = 1 << 3,
+};
+
+const int BOT_INPUT_SHIFT = 2; // INPUT_BOT_* >> this = INPUT_*
+
+// Everything needed to advance a match; plain data, safe to copy
+struct World {
+    Circle circle;
+    Vector2 OldPosition;
+    Circle futureCollision;
+    Circle playerFuture; // Same for a bot on the left, kept in mirrored coordinates
+    Rectangle player;
+    Rectangle bot;
+    int playerScore;
+    int botScore;
+    float currentSpeed;
+    Difficulty difficulty;
+    int subSteps; // Ball updates per frame, 1 = classic
+    Rng rng;
+    EventList events; // Filled by the last StepWorld
+};
+
+// Collision detection
+bool CircleOverlapsRect(Vector2 center, float radius, Rectangle rec);
+bool SweepCircleRect(Vector2 from, Vector2 to, float radius, Rectangle rec, float& t);
+// radius: the classic ball unless given (chaos mode uses smaller ones)
+void CircleCollideWith(Circle& circle, Rectangle player, Rectangle bot, float radius = BALL_RADIUS);
+void CircleCollideWith(Circle& circle, Vector2 oldPosition, Rectangle player, Rectangle bot, float radius = BALL_RADIUS);
+// hitTime: how far along the step from oldPosition a swept paddle hit was
+// found, 0 when the ball wasn't moved back
+void CircleCollideWith(Circle& circle, Vector2 oldPosition, Rectangle player, Rectangle bot, float radius, float& hitTime);
+void CircleCollideWith(Circle& circle);
+
+Vector2 randomDirection(Rng& rng, float dep);
+bool withinHigh(Rectangle rec);
+bool withinLow(Rectangle rec);
+
+Circle PointOfCollision(Circle circle, Vector2 oldPosition);
+void IncreaseSpeed(Circle circle, Vector2& Velocity, float& currentSpeed, float stepFraction = 1.0f);
+Circle RightBorderCollision(Circle circle, Vector2 oldPosition);
+
+// stepFraction < 1 advances the ball by that part of a frame (sub-stepping);
+// the velocity implied by OldPosition is then per sub-step too
+int move(Circle& circle, Vector2& OldPosition, float dep, Rectangle player, Rectangle bot, float& currentSpeed,
+         Rng& rng, EventList& events, float stepFraction = 1.0f);
+
+// Bots
+void moveBotEasy(Rectangle& bot, Vector2 circle);
+void moveBotMedium(Rectangle& bot, Circle circle, Vector2 oldPosition, Circle& futureCollision);
+void moveBotHard(Rectangle& bot, Circle circle, Vector2 oldPosition, Circle& futureCollision);
+
+// Any bot, written for the right paddle; futureCollision is its own memory
+typedef void (*BotFunction)(Rectangle& bot, Circle circle, Vector2 oldPosition, Circle& futureCollision);
+BotFunction BotForDifficulty(Difficulty difficulty); // EXPERT keeps state of its own; HARD stands in
+
+// Mirror left <-> right, so a right-side bot can play the left paddle
+Vector2 MirrorPoint(Vector2 point);
+Rectangle MirrorRect(Rectangle rec);
+Circle MirrorCircle(Circle circle);
+
+// Match
+void ResetBall(World& world);
+void ResetWorld(World& world, Difficulty difficulty, uint64_t seed);
+void MovePaddle(Rectangle& paddle, uint8_t input); // PLAYER_SPEED, kept inside the play area
+void StepWorld(World& world, uint8_t input);
+void StepWorldBots(World& world, BotFunction left, BotFunction right); // Bot vs bot
+void StepWorldPlayers(World& world, uint8_t left, uint8_t right);     // Two players, 'bot' is the right paddle
+bool IsMatchOver(const World& world);
+
+#endif //PONG_CORE_H
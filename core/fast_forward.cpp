@@ -0,0 +1,238 @@
+#include "fast_forward.h"
+#include <cmath>
+#include <cstring>
+
+// One frame of the ball's straight flight, what move() does without a collision
+static void StepAxis(float& x, float& old) {
+    float velocity = x - old;
+    old = x;
+    x = x + velocity;
+}
+
+// Powers of two straight from the exponent bits
+static float PowerOfTwo(int exponent) {
+    uint32_t bits = (uint32_t)(exponent + 127) << 23;
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+// 'frames' frames of StepAxis. With x in [2^(e-1), 2^e) and the velocity a
+// multiple of that range's float step, x + velocity is exact for as long
+// as it stays in the range, and so is the velocity read back the next
+// frame. Those frames are one jump; a frame leaving the range (where the
+// sum may round) is stepped as is.
+static void AdvanceAxis(float& x, float& old, long frames) {
+    while (frames > 0) {
+        float velocity = x - old;
+        long run = 0;
+        if (x >= 1.0f && x < 65536.0f && velocity != 0.0f) {
+            uint32_t bits;
+            memcpy(&bits, &x, 4);
+            int exponent = (int)(bits >> 23) - 126;
+            float steps = velocity * PowerOfTwo(24 - exponent); // Exact
+            if (steps == truncf(steps)) {
+                double lo = PowerOfTwo(exponent - 1);
+                double hi = PowerOfTwo(exponent);
+                run = (long)(velocity > 0.0f ? (hi - x) / velocity : (x - lo) / -velocity);
+                while (run > 0 && (x + run * (double)velocity >= hi || x + run * (double)velocity < lo)) run--;
+            }
+        }
+        if (run > 0) {
+            if (run > frames) run = frames;
+            old = (float)(x + (run - 1) * (double)velocity);
+            x = (float)(x + run * (double)velocity);
+        } else {
+            StepAxis(x, old);
+            run = 1;
+        }
+        frames -= run;
+    }
+}
+
+// Ball positions where CircleCollideWith can't find anything: inside the
+// walls and clear of both paddles' columns, whatever their height
+static bool IsQuiet(const World& world, Vector2 center, Vector2 old) {
+    float left = world.player.x + world.player.width + BALL_RADIUS;
+    float right = world.bot.x - BALL_RADIUS;
+    return fminf(center.x, old.x) > left && fmaxf(center.x, old.x) < right &&
+           center.y >= PLAY_AREA_TOP + BALL_RADIUS && center.y <= PLAY_AREA_BOTTOM - BALL_RADIUS &&
+           !(old == center); // Would serve
+}
+
+// Frames from now that start with the ball quiet, 0 if this one doesn't,
+// and the ball at the start of the last of them. Along a straight line
+// each coordinate only moves one way, so the first and last positions
+// being quiet covers every one in between.
+static long QuietFrames(const World& world, long frames, Vector2& last, Vector2& before) {
+    Vector2 center = world.circle.center;
+    Vector2 old = world.OldPosition;
+    if (world.subSteps > 1 || frames < 1 || !IsQuiet(world, center, old)) return 0;
+
+    float left = world.player.x + world.player.width + BALL_RADIUS;
+    float right = world.bot.x - BALL_RADIUS;
+    Vector2 velocity = center - old;
+    double limit = (double)frames;
+    if (velocity.x > 0.0f) limit = fmin(limit, (right - center.x) / velocity.x);
+    if (velocity.x < 0.0f) limit = fmin(limit, (center.x - left) / -velocity.x);
+    if (velocity.y > 0.0f) limit = fmin(limit, (PLAY_AREA_BOTTOM - BALL_RADIUS - center.y) / velocity.y);
+    if (velocity.y < 0.0f) limit = fmin(limit, (center.y - PLAY_AREA_TOP - BALL_RADIUS) / -velocity.y);
+
+    long quiet = limit > 1.0 ? (long)limit : 1;
+    for (;;) {
+        last = center;
+        before = old;
+        AdvanceAxis(last.x, before.x, quiet - 1);
+        AdvanceAxis(last.y, before.y, quiet - 1);
+        if (quiet == 1 || IsQuiet(world, last, before)) return quiet;
+        quiet /= 2; // Rounding put the estimate right at the edge
+    }
+}
+
+// A paddle while the ball is quiet
+struct QuietPaddle {
+    Rectangle* paddle;
+    BotFunction bot; // nullptr: moved by 'input'
+    uint8_t input;
+    bool mirrored;   // Left bot, plays in a mirrored world
+    Circle* future;  // The bot's own memory
+};
+
+// Height after one quiet frame, the ball at center/old
+static float QuietMove(const QuietPaddle& p, float y, Vector2 center, Vector2 old) {
+    Rectangle rec = *p.paddle;
+    rec.y = y;
+    if (!p.bot) {
+        MovePaddle(rec, p.input);
+    } else if (p.mirrored) {
+        rec = MirrorRect(rec);
+        p.bot(rec, MirrorCircle({center, NO_COL}), MirrorPoint(old), *p.future);
+    } else {
+        p.bot(rec, {center, NO_COL}, old, *p.future);
+    }
+    return rec.y;
+}
+
+// Held keys, the hard bot, and the medium bot once it has a prediction
+// only look at the paddle's own height while the ball is quiet
+static bool FollowsBall(const QuietPaddle& p) {
+    if (!p.bot || p.bot == moveBotHard) return false;
+    return !(p.bot == moveBotMedium && p.future->Collision == RIGHT_BORDER);
+}
+
+// 'frames' quiet frames of a paddle that doesn't follow the ball. It moves
+// in whole steps while it heads somewhere, then stops or flips between two
+// heights. Every condition on the way is a threshold on the height, so the
+// frames that still take a plain step form one run, found by galloping and
+// bisecting instead of going frame by frame.
+static float AdvancePaddle(const QuietPaddle& p, long frames, Vector2 center, Vector2 old) {
+    float y = p.paddle->y;
+    while (frames > 0) {
+        float next = QuietMove(p, y, center, old);
+        if (next == y) break;
+        if (QuietMove(p, next, center, old) == y) {
+            if (frames % 2) y = next;
+            break;
+        }
+
+        float step = next - y;
+        long run = 1;
+        if (y == floorf(y) && step == floorf(step)) { // Sums of whole numbers are exact
+            long limit = frames < (1 << 20) ? frames : (1 << 20);
+            auto plain = [&](long j) { return QuietMove(p, y + j * step, center, old) == y + (j + 1) * step; };
+            long lo = 0; // plain(lo) holds
+            long hi = 1;
+            while (hi < limit && plain(hi)) {
+                lo = hi;
+                hi *= 2;
+            }
+            if (hi > limit) hi = limit;
+            while (hi - lo > 1) {
+                long mid = (lo + hi) / 2;
+                if (plain(mid)) lo = mid;
+                else hi = mid;
+            }
+            run = lo + 1;
+        }
+        y += run * step;
+        frames -= run;
+    }
+    return y;
+}
+
+// last/before: the ball at the start of the last frame, from QuietFrames
+static void SkipQuietFrames(World& world, long frames, Vector2 last, Vector2 before, const QuietPaddle* paddles, int count) {
+    world.events.count = 0;
+    world.circle.Collision = NO_COL;
+
+    bool perFrame = false;
+    for (int i = 0; i < count; i++) {
+        if (FollowsBall(paddles[i])) perFrame = true;
+        else paddles[i].paddle->y = AdvancePaddle(paddles[i], frames, world.circle.center, world.OldPosition);
+    }
+    if (!perFrame) {
+        StepAxis(last.x, before.x);
+        StepAxis(last.y, before.y);
+        world.circle.center = last;
+        world.OldPosition = before;
+        return;
+    }
+
+    // Ball first, then the paddles that watch it, like StepWorld
+    for (long n = 0; n < frames; n++) {
+        StepAxis(world.circle.center.x, world.OldPosition.x);
+        StepAxis(world.circle.center.y, world.OldPosition.y);
+        for (int i = 0; i < count; i++) {
+            if (FollowsBall(paddles[i])) {
+                paddles[i].paddle->y = QuietMove(paddles[i], paddles[i].paddle->y, world.circle.center, world.OldPosition);
+            }
+        }
+    }
+}
+
+long FastForwardWorld(World& world, uint8_t input, long frames) {
+    QuietPaddle paddles[2] = {
+        {&world.player, nullptr, input, false, nullptr},
+        {&world.bot, nullptr, (uint8_t)(input >> BOT_INPUT_SHIFT), false, &world.futureCollision},
+    };
+    if (world.difficulty != EXPERT) paddles[1].bot = BotForDifficulty(world.difficulty);
+
+    long done = 0;
+    while (done < frames) {
+        Vector2 last;
+        Vector2 before;
+        long quiet = QuietFrames(world, frames - done, last, before);
+        if (quiet > 0) {
+            SkipQuietFrames(world, quiet, last, before, paddles, 2);
+            done += quiet;
+            continue;
+        }
+        StepWorld(world, input);
+        done++;
+        if (world.events.count > 0) break;
+    }
+    return done;
+}
+
+long FastForwardBots(World& world, BotFunction left, BotFunction right, long frames) {
+    QuietPaddle paddles[2] = {
+        {&world.player, left, 0, true, &world.playerFuture},
+        {&world.bot, right, 0, false, &world.futureCollision},
+    };
+
+    long done = 0;
+    while (done < frames) {
+        Vector2 last;
+        Vector2 before;
+        long quiet = QuietFrames(world, frames - done, last, before);
+        if (quiet > 0) {
+            SkipQuietFrames(world, quiet, last, before, paddles, 2);
+            done += quiet;
+            continue;
+        }
+        StepWorldBots(world, left, right);
+        done++;
+        if (world.events.count > 0) break;
+    }
+    return done;
+}
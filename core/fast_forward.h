@@ -0,0 +1,31 @@
+#ifndef PONG_FAST_FORWARD_H
+#define PONG_FAST_FORWARD_H
+
+#include "core.h"
+
+// Event-driven stepping for headless runs. Between a hit and the next one
+// the ball flies in a straight line through frames where nothing can
+// happen: it's clear of the walls and of the paddles' columns, so no
+// collision test can fire. The number of such frames is worked out from
+// the ball's velocity and the whole stretch is skipped at once, then the
+// frames around the next event are stepped as usual.
+//
+// Results are bit-identical to stepping frame by frame. The ball's float
+// position is jumped exactly: while it stays within one power of two its
+// per-frame velocity is a whole number of float steps, so every addition
+// in move() is exact and the velocity never changes. Paddles heading for a
+// fixed height (a held key, the hard bot, the medium bot once it knows
+// where the ball will arrive) depend on nothing but their own position and
+// jump in long runs too; paddles following the ball (the easy bot, bots
+// from plug-ins) are stepped per frame along the skipped stretch, still
+// without any collision work. Sub-stepped worlds are stepped frame by frame.
+
+// Same as up to 'frames' calls of StepWorld(world, input), but returns
+// right after a frame with events, so world.events is never missed.
+// Returns the frames stepped, at least 1 when frames > 0.
+long FastForwardWorld(World& world, uint8_t input, long frames);
+
+// Same for StepWorldBots
+long FastForwardBots(World& world, BotFunction left, BotFunction right, long frames);
+
+#endif //PONG_FAST_FORWARD_H
@@ -0,0 +1,76 @@
+#include "fixed.h"
+#include <cmath>
+
+Fixed ToFixed(float value) {
+    return (Fixed)floorf(value * FIXED_ONE + 0.5f);
+}
+
+uint64_t IntSqrt(uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > value) bit >>= 2;
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+Fixed FixedSqrt(Fixed value) {
+    if (value <= 0) return 0;
+    return (Fixed)IntSqrt((uint64_t)value << FIXED_BITS);
+}
+
+// Quarter sine wave, 0 to 90 degrees. Taylor series in 2.30 fixed point,
+// so the table comes out the same whatever compiles it.
+const int QUARTER_TURN = 90 * ANGLE_STEPS;
+
+struct SineTable {
+    int32_t values[QUARTER_TURN + 1];
+};
+
+static constexpr SineTable MakeSineTable() {
+    const int64_t PI_Q30 = 3373259426; // pi * 2^30
+    SineTable table = {};
+    for (int a = 0; a <= QUARTER_TURN; a++) {
+        int64_t x = PI_Q30 * a / (180 * ANGLE_STEPS);
+        int64_t x2 = (x * x) >> 30;
+        int64_t term = x;
+        int64_t sum = x;
+        for (int n = 1; n < 12; n++) {
+            term = -((term * x2) >> 30) / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        table.values[a] = (int32_t)((sum + (1 << (29 - SINE_BITS))) >> (30 - SINE_BITS));
+    }
+    return table;
+}
+
+static constexpr SineTable SINE = MakeSineTable();
+static_assert(SINE.values[0] == 0, "sin 0");
+static_assert(SINE.values[30 * ANGLE_STEPS] == 1 << (SINE_BITS - 1), "sin 30");
+static_assert(SINE.values[QUARTER_TURN] == 1 << SINE_BITS, "sin 90");
+
+int32_t FixedSin(int angle) {
+    const int FULL_TURN = 4 * QUARTER_TURN;
+    angle %= FULL_TURN;
+    if (angle < 0) angle += FULL_TURN;
+    if (angle <= QUARTER_TURN) return SINE.values[angle];
+    if (angle <= 2 * QUARTER_TURN) return SINE.values[2 * QUARTER_TURN - angle];
+    if (angle <= 3 * QUARTER_TURN) return -SINE.values[angle - 2 * QUARTER_TURN];
+    return -SINE.values[FULL_TURN - angle];
+}
+
+int32_t FixedCos(int angle) {
+    return FixedSin(angle + QUARTER_TURN);
+}
+
+void FixedPolar(Fixed length, int angle, Fixed& x, Fixed& y) {
+    x = (Fixed)(((int64_t)length * FixedCos(angle)) >> SINE_BITS);
+    y = (Fixed)(((int64_t)length * FixedSin(angle)) >> SINE_BITS);
+}
@@ -0,0 +1,55 @@
+#ifndef PONG_FIXED_H
+#define PONG_FIXED_H
+
+#include <cstdint>
+
+// Fixed-point scalar for the deterministic build (PONG_FIXED_POINT).
+// Simulation values keep FIXED_BITS fraction bits but stay in the World's
+// floats: on that grid and below 2^15 a float holds them exactly, so adding,
+// subtracting and comparing them gives the same answer on every IEEE build.
+// Everything else the ball needs - products, quotients, square roots and
+// angles - goes through the integer helpers below instead of float math
+// and libm, whose results depend on the compiler, its flags and the CPU.
+
+typedef int32_t Fixed;
+
+const int FIXED_BITS = 8;
+const Fixed FIXED_ONE = 1 << FIXED_BITS;
+
+// Physics the build simulates with; replays record it
+#ifdef PONG_FIXED_POINT
+const uint32_t PHYSICS_MODE = 1;
+#else
+const uint32_t PHYSICS_MODE = 0;
+#endif
+
+Fixed ToFixed(float value); // Nearest grid value
+inline float FromFixed(Fixed value) {
+    return (float)value / FIXED_ONE; // Exact
+}
+
+// Rounded toward minus infinity, like a right shift
+inline Fixed FixedMul(Fixed a, Fixed b) {
+    return (Fixed)(((int64_t)a * b) >> FIXED_BITS);
+}
+
+// Rounded toward zero
+inline Fixed FixedDiv(Fixed a, Fixed b) {
+    return (Fixed)(((int64_t)a * FIXED_ONE) / b);
+}
+
+uint64_t IntSqrt(uint64_t value); // Floor
+Fixed FixedSqrt(Fixed value);     // 0 for negative values
+
+// Angles are whole 1/ANGLE_STEPS degrees; results have SINE_BITS fraction
+// bits, from a quarter-wave table built at compile time with integer math
+const int ANGLE_STEPS = 16;
+const int SINE_BITS = 16;
+
+int32_t FixedSin(int angle);
+int32_t FixedCos(int angle);
+
+// length * cos(angle), length * sin(angle)
+void FixedPolar(Fixed length, int angle, Fixed& x, Fixed& y);
+
+#endif //PONG_FIXED_H
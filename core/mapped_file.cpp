@@ -0,0 +1,60 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MapFile(MappedFile& mapped, const char* path) {
+    mapped = {nullptr, 0, nullptr, nullptr};
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    mapped = {(const uint8_t*)view, (size_t)size.QuadPart, mapping, file};
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file alive
+    if (view == MAP_FAILED) return false;
+    mapped = {(const uint8_t*)view, (size_t)info.st_size, nullptr, nullptr};
+#endif
+    return true;
+}
+
+void UnmapFile(MappedFile& mapped) {
+    if (!mapped.data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(mapped.data);
+    CloseHandle((HANDLE)mapped.handle);
+    CloseHandle((HANDLE)mapped.file);
+#else
+    munmap((void*)mapped.data, mapped.size);
+#endif
+    mapped = {nullptr, 0, nullptr, nullptr};
+}
@@ -0,0 +1,18 @@
+#ifndef PONG_MAPPED_FILE_H
+#define PONG_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Read-only memory map of a whole file
+struct MappedFile {
+    const uint8_t* data;
+    size_t size;
+    void* handle;  // Windows: file mapping object
+    void* file;    // Windows: file handle
+};
+
+bool MapFile(MappedFile& mapped, const char* path);
+void UnmapFile(MappedFile& mapped);
+
+#endif //PONG_MAPPED_FILE_H
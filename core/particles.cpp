@@ -0,0 +1,123 @@
+#include "particles.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PONG_PARTICLES_SSE
+#endif
+
+const float PARTICLE_DAMPING = 0.95f;
+
+// Unit vectors for every whole degree, so a burst costs no trig calls
+struct DirectionTable {
+    float x[361];
+    float y[361];
+
+    DirectionTable() {
+        for (int i = 0; i <= 360; i++) {
+            double angle = i * 3.14159265358979323846 / 180.0;
+            x[i] = (float)cos(angle);
+            y[i] = (float)sin(angle);
+        }
+    }
+};
+
+static const DirectionTable& Directions() {
+    static const DirectionTable table;
+    return table;
+}
+
+void InitParticlePool(ParticlePool& pool, int capacity) {
+    if (capacity < 0) capacity = 0;
+    // Padded to whole SIMD lanes so the update never needs a scalar tail
+    int padded = (capacity + 3) & ~3;
+    pool.capacity = capacity;
+    pool.count = 0;
+    pool.positionX.assign(padded, 0.0f);
+    pool.positionY.assign(padded, 0.0f);
+    pool.velocityX.assign(padded, 0.0f);
+    pool.velocityY.assign(padded, 0.0f);
+    pool.lifetime.assign(padded, 0.0f);
+    pool.color.assign(padded, Color{0, 0, 0, 0});
+}
+
+void ClearParticles(ParticlePool& pool) {
+    pool.count = 0;
+}
+
+void CopyParticles(ParticlePool& to, const ParticlePool& from) {
+    int count = from.count < to.capacity ? from.count : to.capacity;
+    std::copy_n(from.positionX.begin(), count, to.positionX.begin());
+    std::copy_n(from.positionY.begin(), count, to.positionY.begin());
+    std::copy_n(from.velocityX.begin(), count, to.velocityX.begin());
+    std::copy_n(from.velocityY.begin(), count, to.velocityY.begin());
+    std::copy_n(from.lifetime.begin(), count, to.lifetime.begin());
+    std::copy_n(from.color.begin(), count, to.color.begin());
+    to.count = count;
+}
+
+void SpawnParticles(ParticlePool& pool, Rng& rng, Vector2 position, Color color, int count) {
+    const DirectionTable& directions = Directions();
+    if (count > pool.capacity - pool.count) count = pool.capacity - pool.count;
+
+    for (int i = 0; i < count; i++) {
+        int p = pool.count++;
+        int angle = RandomValue(rng, 0, 360);
+        float speed = (float)RandomValue(rng, 50, 200);
+        pool.positionX[p] = position.x;
+        pool.positionY[p] = position.y;
+        pool.velocityX[p] = directions.x[angle] * speed;
+        pool.velocityY[p] = directions.y[angle] * speed;
+        pool.lifetime[p] = RandomValue(rng, 20, 60) / 60.0f;
+        pool.color[p] = color;
+    }
+}
+
+void UpdateParticles(ParticlePool& pool, float deltaTime) {
+    float* px = pool.positionX.data();
+    float* py = pool.positionY.data();
+    float* vx = pool.velocityX.data();
+    float* vy = pool.velocityY.data();
+    float* life = pool.lifetime.data();
+    int lanes = (pool.count + 3) & ~3;
+
+    // Integrate and damp everyone, dead or alive; the dead are dropped below
+#ifdef PONG_PARTICLES_SSE
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 damping = _mm_set1_ps(PARTICLE_DAMPING);
+    for (int i = 0; i < lanes; i += 4) {
+        __m128 velX = _mm_loadu_ps(vx + i);
+        __m128 velY = _mm_loadu_ps(vy + i);
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velX, dt)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velY, dt)));
+        _mm_storeu_ps(vx + i, _mm_mul_ps(velX, damping));
+        _mm_storeu_ps(vy + i, _mm_mul_ps(velY, damping));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt));
+    }
+#else
+    for (int i = 0; i < lanes; i++) {
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        vx[i] *= PARTICLE_DAMPING;
+        vy[i] *= PARTICLE_DAMPING;
+        life[i] -= deltaTime;
+    }
+#endif
+
+    // Swap-with-last removal
+    int i = 0;
+    while (i < pool.count) {
+        if (life[i] <= 0) {
+            int last = --pool.count;
+            px[i] = px[last];
+            py[i] = py[last];
+            vx[i] = vx[last];
+            vy[i] = vy[last];
+            life[i] = life[last];
+            pool.color[i] = pool.color[last];
+        } else {
+            i++;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef PONG_PARTICLES_H
+#define PONG_PARTICLES_H
+
+#include <vector>
+#include "core.h"
+
+// Particle system
+// Fixed-capacity pool in structure-of-arrays layout: spawning never
+// allocates, a dead particle is replaced by the last live one, and the
+// update runs over plain float arrays four lanes at a time.
+
+const int DEFAULT_MAX_PARTICLES = 8192;
+
+struct ParticlePool {
+    int capacity;
+    int count;
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> lifetime;
+    std::vector<Color> color;
+};
+
+void InitParticlePool(ParticlePool& pool, int capacity);
+void ClearParticles(ParticlePool& pool);
+// The live particles, into a pool of the same capacity without allocating
+void CopyParticles(ParticlePool& to, const ParticlePool& from);
+
+// Bursts past the cap are dropped
+void SpawnParticles(ParticlePool& pool, Rng& rng, Vector2 position, Color color, int count);
+void UpdateParticles(ParticlePool& pool, float deltaTime);
+
+#endif //PONG_PARTICLES_H
@@ -0,0 +1,133 @@
+#include "predict.h"
+#include <cmath>
+#include <cstring>
+
+// Whole frames until pos + n * vel leaves [low, high] (0 if it already has)
+static double FramesToLeave(double pos, double vel, double low, double high) {
+    if (pos < low || pos > high) return 0;
+    if (vel > 0) return floor((high - pos) / vel) + 1;
+    if (vel < 0) return floor((low - pos) / vel) + 1;
+    return INFINITY;
+}
+
+// Powers of two straight from the exponent bits
+static float PowerOfTwo(int exponent) {
+    uint32_t bits = (uint32_t)(exponent + 127) << 23;
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+// 'steps' times x = x + velocity in floats, the way PointOfCollision moves
+// the ball, without making them one by one. On [2^(e-1), 2^e) floats are a
+// grid of one step size, and adding the same velocity to any point of it
+// rounds to the same whole number of grid steps, so while the sums stay in
+// that range they are one jump. Not when the velocity sits exactly halfway
+// between two grid steps: then the rounding depends on the point.
+static float AddSteps(float x, float velocity, long steps) {
+    const long SHORT_RUN = 8; // Plain adds are cheaper
+    while (steps > 0) {
+        float next = x + velocity;
+        long run = 1;
+        if (steps > SHORT_RUN && x >= 1.0f && x < 65536.0f && next >= 1.0f) {
+            uint32_t bits;
+            memcpy(&bits, &x, 4);
+            int exponent = (int)(bits >> 23) - 126;
+            double lo = PowerOfTwo(exponent - 1);
+            double hi = PowerOfTwo(exponent);
+            float halfSteps = velocity * PowerOfTwo(25 - exponent); // Exact
+            bool halfway = halfSteps == (float)(int64_t)halfSteps && ((int64_t)halfSteps & 1);
+            double step = (double)next - x; // Exact: both on the grid
+            if (next < hi && !halfway) {
+                // Every sum x + j * step + velocity up to the last one must stay in range
+                double bound = velocity > 0 ? (hi - x - velocity) / step : (x - lo + velocity) / -step;
+                run = bound >= 0.0 ? (long)fmin(bound, (double)steps) + 1 : 1;
+                auto inRange = [&](long j) {
+                    double sum = x + (j - 1) * step + velocity;
+                    return sum >= lo && sum < hi;
+                };
+                while (run > 1 && !inRange(run)) run--;
+                if (run > steps) run = steps;
+                next = (float)(x + run * step);
+            }
+        }
+        x = next;
+        steps -= run;
+    }
+    return x;
+}
+
+static bool PastBorder(Vector2 center) {
+    Circle circle = {center, NO_COL};
+    CircleCollideWith(circle);
+    return circle.Collision != NO_COL;
+}
+
+// Moves the ball to where it's first past a border, as PointOfCollision
+// steps it: the frames are estimated from the velocity, then settled on the
+// exact float positions. Each coordinate only moves one way, so once past
+// a border the ball stays past.
+static Vector2 StepToBorder(Vector2 center, Vector2 velocity, long& frames) {
+    frames = 0;
+    if (PastBorder(center)) return center;
+    double framesX = FramesToLeave(center.x, velocity.x, BALL_RADIUS, SCREEN_WIDTH - BALL_RADIUS);
+    double framesY = FramesToLeave(center.y, velocity.y, PLAY_AREA_TOP + BALL_RADIUS, PLAY_AREA_BOTTOM - BALL_RADIUS);
+    frames = (long)fmin(framesX, framesY);
+    if (frames < 1) frames = 1;
+
+    Vector2 before = {AddSteps(center.x, velocity.x, frames - 1), AddSteps(center.y, velocity.y, frames - 1)};
+    while (frames > 1 && PastBorder(before)) { // Rounding put the estimate past it
+        frames--;
+        before = {AddSteps(center.x, velocity.x, frames - 1), AddSteps(center.y, velocity.y, frames - 1)};
+    }
+    Vector2 at = before + velocity;
+    while (!PastBorder(at)) {
+        at = at + velocity;
+        frames++;
+    }
+    return at;
+}
+
+Circle PredictCollision(Circle circle, Vector2 oldPosition) {
+    Vector2 Velocity = circle.center - oldPosition;
+    CircleCollideWith(circle);
+    if (circle.Collision != NO_COL || (Velocity.x == 0 && Velocity.y == 0)) {
+        return circle;
+    }
+
+    long frames;
+    circle.center = StepToBorder(circle.center, Velocity, frames);
+    CircleCollideWith(circle);
+    return circle;
+}
+
+Intercept PredictRightIntercept(Vector2 position, Vector2 velocity) {
+    if (velocity.x <= 0) {
+        return {position.y, 0, false};
+    }
+
+    // The same walk as RightBorderCollision, a leg at a time: the ball runs
+    // until it's past a border, and a bounce starts the next leg one
+    // reflected step on from wherever it got to, not from the wall. Up to
+    // ten bounces, then it gives up where it is.
+    Vector2 center = position;
+    Vector2 legVelocity = velocity;
+    float frames = 0;
+    for (int bounces = 0;; bounces++) {
+        long leg;
+        center = StepToBorder(center, legVelocity, leg);
+        frames += leg;
+
+        Circle circle = {center, NO_COL};
+        CircleCollideWith(circle);
+        bool bounced = circle.Collision == UPPER_BORDER || circle.Collision == LOWER_BORDER;
+        if (!bounced || bounces == 10) {
+            return {center.y, frames, true};
+        }
+        velocity.y = -velocity.y;
+        Vector2 next = center + velocity;
+        legVelocity = next - center; // What PointOfCollision reads back
+        center = next;
+        frames++;
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef PONG_PREDICT_H
+#define PONG_PREDICT_H
+
+#include "core.h"
+
+// Trajectory prediction. Same questions as PointOfCollision and
+// RightBorderCollision, answered without stepping the ball frame by frame.
+
+struct Intercept {
+    float y;      // Ball center height once past the right border
+    float frames; // Frames until then
+    bool valid;   // False when the ball isn't heading right
+};
+
+// First border the ball reaches, like PointOfCollision. A ball that isn't
+// moving comes back unchanged with NO_COL instead of looping forever.
+Circle PredictCollision(Circle circle, Vector2 oldPosition);
+
+// Where RightBorderCollision ends up, bounce by bounce in O(1) per bounce:
+// the ball's height the frame it's past the right border (or where it is
+// after ten bounces), and the frames until then
+Intercept PredictRightIntercept(Vector2 position, Vector2 velocity);
+
+#endif //PONG_PREDICT_H
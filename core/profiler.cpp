@@ -0,0 +1,175 @@
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+const char* const PROFILE_ZONE_NAMES[ZONE_COUNT] = {
+    "frame", "wait", "input", "ball", "bot", "search", "particles",
+    "draw field", "draw sprites", "draw particles", "draw overlay", "present",
+};
+
+thread_local bool profilerEnabled = false;
+
+struct ProfileSample {
+    uint64_t start;
+    uint64_t end;
+    uint32_t frame;
+    uint32_t zone;
+};
+
+const uint32_t RING_SIZE = 1 << 16; // Power of two, about half a second of samples at 10k fps
+
+// Single producer (the game thread), single consumer (the writer thread).
+// Indices only grow; the slot is index & (RING_SIZE - 1).
+struct SampleRing {
+    std::vector<ProfileSample> samples;
+    std::atomic<uint32_t> head; // Next slot to write, owned by the producer
+    std::atomic<uint32_t> tail; // Next slot to read, owned by the consumer
+};
+
+static SampleRing ring;
+static std::atomic<uint64_t> dropped;
+static std::thread writer;
+static std::atomic<bool> writerRunning;
+static FILE* csvFile;
+static FILE* traceFile;
+static bool firstTraceEvent;
+
+static uint64_t epoch;
+static uint32_t frameIndex;
+static uint64_t frameStart;
+static uint64_t frameTotals[ZONE_COUNT]; // Nanoseconds so far this frame
+static float history[ZONE_COUNT][PROFILE_HISTORY];
+static int historyCount;
+static int historyNext;
+
+uint64_t ProfileNow() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool PushSample(const ProfileSample& sample) {
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    uint32_t tail = ring.tail.load(std::memory_order_acquire);
+    if (head - tail == RING_SIZE) return false;
+    ring.samples[head & (RING_SIZE - 1)] = sample;
+    ring.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+static void WriteSample(const ProfileSample& sample) {
+    double start = (sample.start - epoch) / 1000.0;
+    double duration = (sample.end - sample.start) / 1000.0;
+    if (csvFile) {
+        fprintf(csvFile, "%u,%s,%.3f,%.3f\n", sample.frame, PROFILE_ZONE_NAMES[sample.zone], start, duration);
+    }
+    if (traceFile) {
+        fprintf(traceFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+                firstTraceEvent ? "" : ",\n", PROFILE_ZONE_NAMES[sample.zone], start, duration, sample.frame);
+        firstTraceEvent = false;
+    }
+}
+
+static void DrainSamples() {
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    uint32_t head = ring.head.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+        WriteSample(ring.samples[tail & (RING_SIZE - 1)]);
+    }
+    ring.tail.store(tail, std::memory_order_release);
+}
+
+static void WriterLoop() {
+    for (;;) {
+        bool running = writerRunning.load(std::memory_order_acquire);
+        DrainSamples();
+        if (!running) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+void InitProfiler(const char* csvPath, const char* tracePath) {
+    epoch = ProfileNow();
+    frameIndex = 0;
+    frameStart = 0;
+    historyCount = 0;
+    historyNext = 0;
+    std::fill(frameTotals, frameTotals + ZONE_COUNT, 0);
+
+    csvFile = csvPath ? fopen(csvPath, "w") : nullptr;
+    traceFile = tracePath ? fopen(tracePath, "w") : nullptr;
+    if (csvFile) fprintf(csvFile, "frame,zone,start_us,duration_us\n");
+    if (traceFile) fprintf(traceFile, "[\n");
+    firstTraceEvent = true;
+
+    if (csvFile || traceFile) {
+        ring.samples.assign(RING_SIZE, ProfileSample{});
+        ring.head.store(0);
+        ring.tail.store(0);
+        dropped.store(0);
+        writerRunning.store(true);
+        writer = std::thread(WriterLoop);
+    }
+    profilerEnabled = true;
+}
+
+void ShutdownProfiler() {
+    profilerEnabled = false;
+    if (writer.joinable()) {
+        writerRunning.store(false, std::memory_order_release);
+        writer.join();
+    }
+    if (csvFile) fclose(csvFile);
+    if (traceFile) {
+        fprintf(traceFile, "\n]\n");
+        fclose(traceFile);
+    }
+    csvFile = nullptr;
+    traceFile = nullptr;
+}
+
+void ProfileRecord(ProfileZone zone, uint64_t start, uint64_t end) {
+    frameTotals[zone] += end - start;
+    if (writer.joinable() && !PushSample({start, end, frameIndex, (uint32_t)zone})) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ProfileFrameEnd() {
+    if (!profilerEnabled) return;
+    uint64_t now = ProfileNow();
+    if (frameStart) ProfileRecord(ZONE_FRAME, frameStart, now);
+    frameStart = now;
+
+    for (int zone = 0; zone < ZONE_COUNT; zone++) {
+        history[zone][historyNext] = frameTotals[zone] / 1e6f;
+        frameTotals[zone] = 0;
+    }
+    historyNext = (historyNext + 1) % PROFILE_HISTORY;
+    if (historyCount < PROFILE_HISTORY) historyCount++;
+    frameIndex++;
+}
+
+int ProfileHistory(ProfileZone zone, float* out) {
+    int oldest = (historyNext - historyCount + PROFILE_HISTORY) % PROFILE_HISTORY;
+    for (int i = 0; i < historyCount; i++) {
+        out[i] = history[zone][(oldest + i) % PROFILE_HISTORY];
+    }
+    return historyCount;
+}
+
+float ProfilePercentile(ProfileZone zone, float percentile) {
+    float sorted[PROFILE_HISTORY];
+    int n = ProfileHistory(zone, sorted);
+    if (n == 0) return 0.0f;
+    int k = std::min(n - 1, (int)(percentile / 100.0f * n));
+    std::nth_element(sorted, sorted + k, sorted + n);
+    return sorted[k];
+}
+
+uint64_t ProfileDroppedSamples() {
+    return dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,63 @@
+#ifndef PONG_PROFILER_H
+#define PONG_PROFILER_H
+
+#include <cstdint>
+
+// Frame profiler. Scoped zones add their time to the current frame; the
+// last PROFILE_HISTORY frames are kept per zone for the overlay. When an
+// export file is given, every zone sample also goes through a lock-free
+// single-producer ring to a writer thread that streams it to disk.
+// Zones are recorded from one thread, the one that called InitProfiler;
+// off, at the cost of one branch per zone, until then and on every other
+// thread.
+
+enum ProfileZone {
+    ZONE_FRAME,          // Whole frame, end to end
+    ZONE_WAIT,           // Low-latency frame pacing
+    ZONE_INPUT,
+    ZONE_BALL,           // Scoring, move and collisions
+    ZONE_BOT,
+    ZONE_SEARCH,         // Expert bot's thinking
+    ZONE_PARTICLES,      // UpdateParticles
+    ZONE_DRAW_FIELD,     // Playfield, scores and text
+    ZONE_DRAW_SPRITES,   // Paddles and ball
+    ZONE_DRAW_PARTICLES,
+    ZONE_DRAW_OVERLAY,   // Menus, stats, this profiler
+    ZONE_PRESENT,        // EndDrawing: swap, vsync, input poll
+    ZONE_COUNT,
+};
+
+extern const char* const PROFILE_ZONE_NAMES[ZONE_COUNT];
+
+const int PROFILE_HISTORY = 240;
+
+extern thread_local bool profilerEnabled;
+
+// csvPath / tracePath may be null; a trace opens in chrome://tracing or Perfetto
+void InitProfiler(const char* csvPath, const char* tracePath);
+void ShutdownProfiler(); // Flushes the export files
+
+uint64_t ProfileNow(); // Nanoseconds
+void ProfileRecord(ProfileZone zone, uint64_t start, uint64_t end);
+void ProfileFrameEnd();
+
+// Per-zone milliseconds for the last frames, oldest first
+int ProfileHistory(ProfileZone zone, float* out);
+float ProfilePercentile(ProfileZone zone, float percentile);
+uint64_t ProfileDroppedSamples(); // Ring was full
+
+struct ProfileScope {
+    ProfileZone zone;
+    uint64_t start;
+
+    explicit ProfileScope(ProfileZone zone) : zone(zone), start(profilerEnabled ? ProfileNow() : 0) {}
+    ~ProfileScope() {
+        if (start) ProfileRecord(zone, start, ProfileNow());
+    }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(zone) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(zone)
+
+#endif //PONG_PROFILER_H
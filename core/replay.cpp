@@ -0,0 +1,288 @@
+#include "replay.h"
+#include "fast_forward.h"
+#include "fixed.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+const char REPLAY_MAGIC[8] = {'P', 'O', 'N', 'G', 'R', 'P', 'L', 'Y'};
+const uint32_t HEADER_SIZE = 48;
+const uint32_t STATE_WORDS = 24;
+const uint32_t KEYFRAME_SIZE = 12 + STATE_WORDS * 4; // frame, input offset, run start, state
+const int RUN_INPUT_BITS = 4; // Player's and expert bot's input bits
+const uint64_t RUN_INPUT_MASK = (1 << RUN_INPUT_BITS) - 1;
+
+// Little-endian fields, whatever the host
+static void PutU32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint32_t GetU32(const uint8_t* in) {
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+static uint32_t FloatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+static float BitsFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+// Everything StepWorld reads, as exact bit patterns
+static void PackState(const World& world, uint32_t* words) {
+    const float floats[] = {
+        world.circle.center.x, world.circle.center.y,
+        world.OldPosition.x, world.OldPosition.y,
+        world.futureCollision.center.x, world.futureCollision.center.y,
+        world.playerFuture.center.x, world.playerFuture.center.y,
+        world.player.x, world.player.y, world.player.width, world.player.height,
+        world.bot.x, world.bot.y, world.bot.width, world.bot.height,
+        world.currentSpeed,
+    };
+    int n = 0;
+    for (float value : floats) words[n++] = FloatBits(value);
+    words[n++] = world.circle.Collision;
+    words[n++] = world.futureCollision.Collision;
+    words[n++] = world.playerFuture.Collision;
+    words[n++] = (uint32_t)world.playerScore;
+    words[n++] = (uint32_t)world.botScore;
+    words[n++] = (uint32_t)world.rng.state;
+    words[n++] = (uint32_t)(world.rng.state >> 32);
+}
+
+static void UnpackState(World& world, const uint32_t* words) {
+    float floats[17];
+    for (int i = 0; i < 17; i++) floats[i] = BitsFloat(words[i]);
+    world.circle.center = {floats[0], floats[1]};
+    world.OldPosition = {floats[2], floats[3]};
+    world.futureCollision.center = {floats[4], floats[5]};
+    world.playerFuture.center = {floats[6], floats[7]};
+    world.player = {floats[8], floats[9], floats[10], floats[11]};
+    world.bot = {floats[12], floats[13], floats[14], floats[15]};
+    world.currentSpeed = floats[16];
+    world.circle.Collision = (Collisions)words[17];
+    world.futureCollision.Collision = (Collisions)words[18];
+    world.playerFuture.Collision = (Collisions)words[19];
+    world.playerScore = (int)words[20];
+    world.botScore = (int)words[21];
+    world.rng.state = (uint64_t)words[22] | (uint64_t)words[23] << 32;
+    world.events.count = 0;
+}
+
+// Input runs: varint of (length << RUN_INPUT_BITS | input bits)
+const int MAX_VARINT_SIZE = 10;
+
+static int PutVarint(uint8_t* out, uint64_t value) {
+    int n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static bool GetVarint(const uint8_t* in, uint32_t size, uint32_t& offset, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && offset < size; shift += 7) {
+        uint8_t byte = in[offset++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Bytes of the open run, 0 if it's empty
+static int EncodeRun(const ReplayWriter& writer, uint8_t* out) {
+    uint32_t length = writer.frame - writer.runStart;
+    if (length == 0) return 0;
+    return PutVarint(out, (uint64_t)length << RUN_INPUT_BITS | (writer.runInput & RUN_INPUT_MASK));
+}
+
+void BeginReplay(ReplayWriter& writer, const World& world, uint64_t seed, int keyframeInterval) {
+    writer.seed = seed;
+    writer.difficulty = world.difficulty;
+    writer.subSteps = world.subSteps;
+    writer.keyframeInterval = keyframeInterval > 0 ? keyframeInterval : REPLAY_KEYFRAME_INTERVAL;
+    writer.frame = 0;
+    writer.runInput = 0;
+    writer.runStart = 0;
+    writer.inputs.clear();
+    writer.keyframes.clear();
+
+    // Room for a long match up front, so recording doesn't allocate mid-game
+    // (clear keeps the capacity for the next one)
+    uint32_t frames = REPLAY_RESERVE_FRAMES;
+    writer.inputs.reserve(frames); // A byte per frame: a new run every frame
+    writer.keyframes.reserve((frames / writer.keyframeInterval + 1) * KEYFRAME_SIZE);
+}
+
+void RecordReplayFrame(ReplayWriter& writer, const World& world, uint8_t input) {
+    input &= INPUT_UP | INPUT_DOWN | INPUT_BOT_UP | INPUT_BOT_DOWN;
+    if (input != writer.runInput) {
+        uint8_t run[MAX_VARINT_SIZE];
+        writer.inputs.insert(writer.inputs.end(), run, run + EncodeRun(writer, run));
+        writer.runInput = input;
+        writer.runStart = writer.frame;
+    }
+
+    // The run holding this frame is written next, at the current end of the input stream
+    if (writer.frame % writer.keyframeInterval == 0) {
+        uint8_t record[KEYFRAME_SIZE];
+        uint32_t words[STATE_WORDS];
+        PackState(world, words);
+        PutU32(record, writer.frame);
+        PutU32(record + 4, (uint32_t)writer.inputs.size());
+        PutU32(record + 8, writer.runStart);
+        for (uint32_t i = 0; i < STATE_WORDS; i++) PutU32(record + 12 + i * 4, words[i]);
+        writer.keyframes.insert(writer.keyframes.end(), record, record + KEYFRAME_SIZE);
+    }
+    writer.frame++;
+}
+
+bool SaveReplay(const ReplayWriter& writer, const char* path) {
+    // The last run is still open
+    uint8_t lastRun[MAX_VARINT_SIZE];
+    size_t lastRunSize = EncodeRun(writer, lastRun);
+
+    uint8_t header[HEADER_SIZE] = {};
+    memcpy(header, REPLAY_MAGIC, 8);
+    PutU32(header + 8, REPLAY_VERSION);
+    PutU32(header + 12, writer.difficulty);
+    PutU32(header + 16, (uint32_t)writer.subSteps);
+    PutU32(header + 20, (uint32_t)writer.keyframeInterval);
+    PutU32(header + 24, (uint32_t)writer.seed);
+    PutU32(header + 28, (uint32_t)(writer.seed >> 32));
+    PutU32(header + 32, writer.frame);
+    PutU32(header + 36, (uint32_t)(writer.keyframes.size() / KEYFRAME_SIZE));
+    PutU32(header + 40, (uint32_t)(writer.inputs.size() + lastRunSize));
+    PutU32(header + 44, PHYSICS_MODE);
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE;
+    ok = ok && fwrite(writer.inputs.data(), 1, writer.inputs.size(), file) == writer.inputs.size();
+    ok = ok && fwrite(lastRun, 1, lastRunSize, file) == lastRunSize;
+    ok = ok && fwrite(writer.keyframes.data(), 1, writer.keyframes.size(), file) == writer.keyframes.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool OpenReplay(ReplayPlayer& player, const char* path) {
+    if (!MapFile(player.file, path)) return false;
+    const uint8_t* data = player.file.data;
+    size_t size = player.file.size;
+
+    bool ok = size >= HEADER_SIZE && memcmp(data, REPLAY_MAGIC, 8) == 0 && GetU32(data + 8) == REPLAY_VERSION;
+    if (ok) {
+        player.difficulty = (Difficulty)GetU32(data + 12);
+        player.keyframeInterval = GetU32(data + 20);
+        player.seed = (uint64_t)GetU32(data + 24) | (uint64_t)GetU32(data + 28) << 32;
+        player.frameCount = GetU32(data + 32);
+        player.keyframeCount = GetU32(data + 36);
+        player.inputSize = GetU32(data + 40);
+        player.inputs = data + HEADER_SIZE;
+        player.keyframes = player.inputs + player.inputSize;
+
+        // A float replay can't play back on fixed-point physics or the other way round
+        ok = GetU32(data + 44) == PHYSICS_MODE && player.difficulty <= EXPERT && player.keyframeInterval > 0 && player.keyframeCount > 0 &&
+             HEADER_SIZE + (uint64_t)player.inputSize + (uint64_t)player.keyframeCount * KEYFRAME_SIZE <= size;
+    }
+    if (!ok) {
+        CloseReplay(player);
+        return false;
+    }
+
+    ResetWorld(player.world, player.difficulty, player.seed);
+    player.world.subSteps = (int)GetU32(data + 16);
+    player.desyncFrame = -1;
+    player.frame = UINT32_MAX; // Nothing loaded yet
+    return SeekReplay(player, 0);
+}
+
+void CloseReplay(ReplayPlayer& player) {
+    UnmapFile(player.file);
+    player.inputs = nullptr;
+    player.keyframes = nullptr;
+    player.frameCount = 0;
+    player.keyframeCount = 0;
+}
+
+static const uint8_t* KeyframeFor(const ReplayPlayer& player, uint32_t frame) {
+    uint32_t index = frame / player.keyframeInterval;
+    if (index >= player.keyframeCount) index = player.keyframeCount - 1;
+    return player.keyframes + (size_t)index * KEYFRAME_SIZE;
+}
+
+// Up to 'frames' frames, stopping at the end of the input run and at the
+// next keyframe so it can be checked; 0 at the end or on a corrupt file
+static uint32_t AdvanceReplay(ReplayPlayer& player, uint32_t frames) {
+    if (!player.keyframes || player.frame >= player.frameCount) return 0;
+    if (player.runLeft == 0) {
+        uint64_t run;
+        if (!GetVarint(player.inputs, player.inputSize, player.inputOffset, run) || (run >> RUN_INPUT_BITS) == 0) return 0;
+        player.runInput = (uint8_t)(run & RUN_INPUT_MASK);
+        player.runLeft = (uint32_t)(run >> RUN_INPUT_BITS);
+    }
+
+    uint32_t toKeyframe = player.keyframeInterval - player.frame % player.keyframeInterval;
+    uint32_t limit = std::min({frames, player.runLeft, toKeyframe, player.frameCount - player.frame});
+    uint32_t stepped = (uint32_t)FastForwardWorld(player.world, player.runInput, limit);
+    player.runLeft -= stepped;
+    player.frame += stepped;
+
+    // Passing a keyframe: the simulation must land on exactly the recorded state
+    if (player.frame % player.keyframeInterval == 0 && player.frame / player.keyframeInterval < player.keyframeCount) {
+        const uint8_t* keyframe = player.keyframes + (size_t)(player.frame / player.keyframeInterval) * KEYFRAME_SIZE;
+        uint32_t words[STATE_WORDS];
+        PackState(player.world, words);
+        for (uint32_t i = 0; i < STATE_WORDS; i++) {
+            if (words[i] != GetU32(keyframe + 12 + i * 4)) {
+                if (player.desyncFrame < 0) player.desyncFrame = player.frame;
+                break;
+            }
+        }
+    }
+    return stepped;
+}
+
+bool SeekReplay(ReplayPlayer& player, uint32_t frame) {
+    if (!player.keyframes || frame > player.frameCount) return false;
+
+    // Going forward from where we are beats reloading a keyframe we've passed
+    const uint8_t* keyframe = KeyframeFor(player, frame);
+    uint32_t keyframeFrame = GetU32(keyframe);
+    if (frame < player.frame || player.frame < keyframeFrame) {
+        uint32_t words[STATE_WORDS];
+        for (uint32_t i = 0; i < STATE_WORDS; i++) words[i] = GetU32(keyframe + 12 + i * 4);
+        UnpackState(player.world, words);
+        player.frame = keyframeFrame;
+        player.inputOffset = GetU32(keyframe + 4);
+        player.runLeft = 0;
+        player.runInput = 0;
+
+        // Skip the part of the run before the keyframe
+        uint32_t runStart = GetU32(keyframe + 8);
+        if (player.frame < player.frameCount) {
+            uint64_t run;
+            if (!GetVarint(player.inputs, player.inputSize, player.inputOffset, run)) return false;
+            player.runInput = (uint8_t)(run & RUN_INPUT_MASK);
+            uint64_t length = run >> RUN_INPUT_BITS;
+            if (runStart > keyframeFrame || runStart + length <= keyframeFrame) return false;
+            player.runLeft = (uint32_t)(runStart + length - keyframeFrame);
+        }
+    }
+
+    while (player.frame < frame) {
+        if (AdvanceReplay(player, frame - player.frame) == 0) return false;
+    }
+    return true;
+}
+
+bool StepReplay(ReplayPlayer& player) {
+    return AdvanceReplay(player, 1) > 0;
+}
@@ -0,0 +1,68 @@
+#ifndef PONG_REPLAY_H
+#define PONG_REPLAY_H
+
+#include <cstdint>
+#include <vector>
+#include "core.h"
+#include "mapped_file.h"
+
+// Replays: a match is its seed plus the player's input bits (with the
+// expert bot's moves, which share the byte), run-length encoded (one varint
+// per run of identical input), so a whole match is a few hundred bytes.
+// Every keyframeInterval frames the full World is stored too; seeking
+// restores the nearest keyframe before the target and steps forward
+// headlessly, and playing through a keyframe checks the simulation still
+// agrees with the recording.
+//
+// File layout (little-endian): header, input runs, keyframes. The header
+// records the physics mode; a replay only opens on a build with the same.
+
+const uint32_t REPLAY_VERSION = 3; // 2: four input bits per run, for the expert bot; 3: full speed off swept paddle hits
+const int REPLAY_KEYFRAME_INTERVAL = 10 * SIM_HZ; // 10 s
+const uint32_t REPLAY_RESERVE_FRAMES = SIM_HZ * 60 * 30; // Buffers BeginReplay sizes for, 30 min
+
+struct ReplayWriter {
+    uint64_t seed;
+    Difficulty difficulty;
+    int subSteps;
+    int keyframeInterval;
+    uint32_t frame;          // Frames recorded so far
+    uint8_t runInput;        // Input of the run being recorded
+    uint32_t runStart;       // Frame the run started on
+    std::vector<uint8_t> inputs;
+    std::vector<uint8_t> keyframes;
+};
+
+// world is the state ResetWorld(world, ..., seed) just produced
+void BeginReplay(ReplayWriter& writer, const World& world, uint64_t seed, int keyframeInterval = REPLAY_KEYFRAME_INTERVAL);
+// Call once per frame before StepWorld(world, input)
+void RecordReplayFrame(ReplayWriter& writer, const World& world, uint8_t input);
+bool SaveReplay(const ReplayWriter& writer, const char* path);
+
+struct ReplayPlayer {
+    MappedFile file;
+    uint64_t seed;
+    Difficulty difficulty;
+    uint32_t frameCount;
+    uint32_t keyframeInterval;
+    uint32_t keyframeCount;
+    const uint8_t* inputs;
+    uint32_t inputSize;
+    const uint8_t* keyframes;
+
+    World world;             // State at the start of 'frame'
+    uint32_t frame;
+    uint32_t inputOffset;    // Next run to decode
+    uint32_t runLeft;        // Frames left in the current run
+    uint8_t runInput;
+    int64_t desyncFrame;     // First keyframe that didn't match, -1 if none
+};
+
+bool OpenReplay(ReplayPlayer& player, const char* path);
+void CloseReplay(ReplayPlayer& player);
+// Jump to any frame in [0, frameCount]
+bool SeekReplay(ReplayPlayer& player, uint32_t frame);
+// Advance one frame, false at the end of the recording (or a corrupt file)
+bool StepReplay(ReplayPlayer& player);
+
+#endif //PONG_REPLAY_H
@@ -0,0 +1,238 @@
+#include "rollback.h"
+#include "fixed.h"
+#include <chrono>
+#include <cstring>
+
+const uint16_t PACKET_MAGIC = 0x4E50; // "PN"
+const uint8_t PACKET_VERSION = 2; // 2: sub-steps and physics mode
+
+void InitRollback(RollbackSession& session, Side localSide, uint64_t seed, int subSteps, int inputDelay) {
+    memset(&session, 0, sizeof(session));
+    session.localSide = localSide;
+    session.inputDelay = inputDelay < 0 ? 0 : (inputDelay > MAX_INPUT_DELAY ? MAX_INPUT_DELAY : inputDelay);
+    session.seed = seed;
+    ResetWorld(session.world, EASY, seed);
+    session.world.subSteps = subSteps;
+
+    for (int i = 0; i < INPUT_HISTORY; i++) {
+        session.local[i].frame = NO_ROLLBACK;
+        session.remote[i].frame = NO_ROLLBACK;
+    }
+    // Both sides start with their delay frames of no input
+    for (int f = 0; f < session.inputDelay; f++) {
+        session.local[f] = {(uint32_t)f, 0, true};
+    }
+    session.localFrame = session.inputDelay;
+    session.rollbackFrame = NO_ROLLBACK;
+    session.desyncFrame = -1;
+}
+
+bool AddLocalInput(RollbackSession& session, uint8_t input) {
+    // One input per simulated frame, however long the session stalls
+    if (session.localFrame > session.frame + session.inputDelay) return false;
+    session.local[session.localFrame % INPUT_HISTORY] = {session.localFrame, (uint8_t)(input & (INPUT_UP | INPUT_DOWN)), true};
+    session.localFrame++;
+    return true;
+}
+
+void AddRemoteInput(RollbackSession& session, uint32_t frame, uint8_t input) {
+    // The slot before confirmedFrame holds the input predictions repeat
+    if (frame < session.confirmedFrame || frame >= session.confirmedFrame + INPUT_HISTORY - 1) return;
+    InputSlot& slot = session.remote[frame % INPUT_HISTORY];
+    if (slot.frame == frame && slot.known) return; // Resent
+
+    // Already simulated with a guess; a wrong guess means going back
+    if (frame < session.frame && slot.frame == frame && slot.input != input) {
+        if (session.rollbackFrame == NO_ROLLBACK || frame < session.rollbackFrame) session.rollbackFrame = frame;
+    }
+    slot = {frame, input, true};
+
+    while (session.remote[session.confirmedFrame % INPUT_HISTORY].frame == session.confirmedFrame &&
+           session.remote[session.confirmedFrame % INPUT_HISTORY].known) {
+        session.confirmedFrame++;
+    }
+}
+
+// The real remote input, or the last confirmed one repeated
+static uint8_t RemoteInput(RollbackSession& session, uint32_t frame) {
+    InputSlot& slot = session.remote[frame % INPUT_HISTORY];
+    if (slot.frame == frame && slot.known) return slot.input;
+
+    uint8_t guess = 0;
+    if (session.confirmedFrame > 0) guess = session.remote[(session.confirmedFrame - 1) % INPUT_HISTORY].input;
+    slot = {frame, guess, false};
+    return guess;
+}
+
+static void SimulateFrame(RollbackSession& session) {
+    uint32_t frame = session.frame;
+    session.snapshots[frame % (ROLLBACK_FRAMES + 1)] = session.world;
+    uint8_t local = session.local[frame % INPUT_HISTORY].input;
+    uint8_t remote = RemoteInput(session, frame);
+    if (session.localSide == LEFT_SIDE) StepWorldPlayers(session.world, local, remote);
+    else StepWorldPlayers(session.world, remote, local);
+    session.frame++;
+}
+
+uint64_t WorldChecksum(const World& world) {
+    // FNV-1a over the fields that carry over between frames
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = (const uint8_t*)data;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(&world.circle.center, sizeof(Vector2));
+    mix(&world.circle.Collision, sizeof(Collisions));
+    mix(&world.OldPosition, sizeof(Vector2));
+    mix(&world.player, sizeof(Rectangle));
+    mix(&world.bot, sizeof(Rectangle));
+    mix(&world.playerScore, sizeof(int));
+    mix(&world.botScore, sizeof(int));
+    mix(&world.currentSpeed, sizeof(float));
+    mix(&world.rng.state, sizeof(uint64_t));
+    return hash;
+}
+
+static void CompareChecksums(RollbackSession& session) {
+    if (session.desyncFrame >= 0 || session.remoteChecksumFrame == 0) return;
+    int slot = (session.remoteChecksumFrame / CHECKSUM_INTERVAL) % CHECKSUM_HISTORY;
+    if (session.checksumFrames[slot] == session.remoteChecksumFrame &&
+        session.checksums[slot] != session.remoteChecksum) {
+        session.desyncFrame = session.remoteChecksumFrame;
+    }
+}
+
+// A state is final once every input before it is confirmed
+static void UpdateChecksums(RollbackSession& session) {
+    uint32_t limit = session.confirmedFrame < session.frame ? session.confirmedFrame : session.frame;
+    for (uint32_t f = session.finalFrame + 1; f <= limit; f++) {
+        if (f % CHECKSUM_INTERVAL != 0 || f + ROLLBACK_FRAMES < session.frame) continue;
+        const World& state = (f == session.frame) ? session.world : session.snapshots[f % (ROLLBACK_FRAMES + 1)];
+        int slot = (f / CHECKSUM_INTERVAL) % CHECKSUM_HISTORY;
+        session.checksumFrames[slot] = f;
+        session.checksums[slot] = WorldChecksum(state);
+        session.lastChecksumFrame = f;
+    }
+    if (limit > session.finalFrame) session.finalFrame = limit;
+    CompareChecksums(session);
+}
+
+bool AdvanceRollback(RollbackSession& session) {
+    if (session.frame >= session.confirmedFrame + ROLLBACK_FRAMES ||
+        session.local[session.frame % INPUT_HISTORY].frame != session.frame) {
+        session.stats.stalls++;
+        return false;
+    }
+
+    if (session.rollbackFrame != NO_ROLLBACK) {
+        auto start = std::chrono::steady_clock::now();
+        uint32_t now = session.frame;
+        int depth = (int)(now - session.rollbackFrame);
+        session.world = session.snapshots[session.rollbackFrame % (ROLLBACK_FRAMES + 1)];
+        session.frame = session.rollbackFrame;
+        while (session.frame < now) SimulateFrame(session);
+        session.rollbackFrame = NO_ROLLBACK;
+
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        RollbackStats& stats = session.stats;
+        stats.rollbacks++;
+        stats.framesResimulated += depth;
+        stats.depthHistogram[depth <= ROLLBACK_FRAMES ? depth : ROLLBACK_FRAMES]++;
+        if (depth > stats.maxDepth) stats.maxDepth = depth;
+        stats.resimMicros += micros;
+        if (micros > stats.maxResimMicros) stats.maxResimMicros = micros;
+    }
+
+    SimulateFrame(session);
+    session.stats.framesSimulated++;
+    UpdateChecksums(session);
+    return true;
+}
+
+void BuildInputPacket(const RollbackSession& session, InputPacket& packet) {
+    // Everything the remote hasn't acknowledged, oldest first
+    uint32_t start = session.remoteAck;
+    if (start + INPUT_HISTORY <= session.localFrame) start = session.localFrame - INPUT_HISTORY + 1;
+    int count = (int)(session.localFrame - start);
+    if (count > MAX_PACKET_INPUTS) count = MAX_PACKET_INPUTS;
+
+    packet.seed = session.seed;
+    packet.subSteps = (uint8_t)session.world.subSteps;
+    packet.physicsMode = (uint8_t)PHYSICS_MODE;
+    packet.startFrame = start;
+    packet.ackFrame = session.confirmedFrame;
+    int slot = (session.lastChecksumFrame / CHECKSUM_INTERVAL) % CHECKSUM_HISTORY;
+    packet.checksumFrame = session.lastChecksumFrame;
+    packet.checksum = session.lastChecksumFrame ? session.checksums[slot] : 0;
+    packet.count = count;
+    for (int i = 0; i < count; i++) {
+        packet.inputs[i] = session.local[(start + i) % INPUT_HISTORY].input;
+    }
+}
+
+void ReceiveInputPacket(RollbackSession& session, const InputPacket& packet) {
+    for (int i = 0; i < packet.count; i++) {
+        AddRemoteInput(session, packet.startFrame + i, packet.inputs[i]);
+    }
+    if (packet.ackFrame > session.remoteAck && packet.ackFrame <= session.localFrame) session.remoteAck = packet.ackFrame;
+    if (packet.checksumFrame > session.remoteChecksumFrame) {
+        session.remoteChecksumFrame = packet.checksumFrame;
+        session.remoteChecksum = packet.checksum;
+        CompareChecksums(session);
+    }
+}
+
+// Little-endian on the wire
+static void PutBytes(uint8_t*& out, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) *out++ = (uint8_t)(value >> (8 * i));
+}
+
+static uint64_t GetBytes(const uint8_t*& in, int size) {
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) value |= (uint64_t)*in++ << (8 * i);
+    return value;
+}
+
+int EncodeInputPacket(const InputPacket& packet, uint8_t* buffer) {
+    uint8_t* out = buffer;
+    PutBytes(out, PACKET_MAGIC, 2);
+    PutBytes(out, PACKET_VERSION, 1);
+    PutBytes(out, (uint64_t)packet.count, 1);
+    PutBytes(out, packet.seed, 8);
+    PutBytes(out, packet.subSteps, 1);
+    PutBytes(out, packet.physicsMode, 1);
+    PutBytes(out, packet.startFrame, 4);
+    PutBytes(out, packet.ackFrame, 4);
+    PutBytes(out, packet.checksumFrame, 4);
+    PutBytes(out, packet.checksum, 8);
+    // Four inputs per byte
+    memset(out, 0, (packet.count + 3) / 4);
+    for (int i = 0; i < packet.count; i++) {
+        out[i / 4] |= (uint8_t)((packet.inputs[i] & 3) << (2 * (i % 4)));
+    }
+    out += (packet.count + 3) / 4;
+    return (int)(out - buffer);
+}
+
+bool DecodeInputPacket(const uint8_t* buffer, int size, InputPacket& packet) {
+    if (size < PACKET_HEADER_SIZE) return false;
+    const uint8_t* in = buffer;
+    if (GetBytes(in, 2) != PACKET_MAGIC || GetBytes(in, 1) != PACKET_VERSION) return false;
+    packet.count = (int)GetBytes(in, 1);
+    if (packet.count > MAX_PACKET_INPUTS || size < PACKET_HEADER_SIZE + (packet.count + 3) / 4) return false;
+    packet.seed = GetBytes(in, 8);
+    packet.subSteps = (uint8_t)GetBytes(in, 1);
+    packet.physicsMode = (uint8_t)GetBytes(in, 1);
+    if (packet.subSteps < 1) return false;
+    packet.startFrame = (uint32_t)GetBytes(in, 4);
+    packet.ackFrame = (uint32_t)GetBytes(in, 4);
+    packet.checksumFrame = (uint32_t)GetBytes(in, 4);
+    packet.checksum = GetBytes(in, 8);
+    for (int i = 0; i < packet.count; i++) {
+        packet.inputs[i] = (in[i / 4] >> (2 * (i % 4))) & 3;
+    }
+    return true;
+}
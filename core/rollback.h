@@ -0,0 +1,101 @@
+#ifndef PONG_ROLLBACK_H
+#define PONG_ROLLBACK_H
+
+#include <cstdint>
+#include "core.h"
+
+// Rollback netplay: each side simulates with its own input and a guess of
+// the other's (the last one it received). Every frame's starting state is
+// kept, so when a real input arrives that differs from the guess the world
+// is restored to that frame and re-simulated up to now, within the same
+// frame. Transport-agnostic: inputs travel in InputPackets, which carry a
+// window of recent inputs so a lost packet is covered by the next one.
+
+const int ROLLBACK_FRAMES = 16;   // Longest prediction; past it the session waits
+const int INPUT_HISTORY = 64;     // Power of two, > 2 * (ROLLBACK_FRAMES + MAX_INPUT_DELAY)
+const int MAX_INPUT_DELAY = 8;
+const int CHECKSUM_INTERVAL = 30; // Frames between desync checks
+const int CHECKSUM_HISTORY = 16;
+
+struct InputSlot {
+    uint32_t frame;
+    uint8_t input;
+    bool known; // false: a prediction
+};
+
+struct RollbackStats {
+    long framesSimulated;
+    long stalls;              // Advance refused: too far ahead of the remote
+    long rollbacks;
+    long framesResimulated;
+    long depthHistogram[ROLLBACK_FRAMES + 1];
+    int maxDepth;
+    double resimMicros;       // Total time spent rolling back
+    double maxResimMicros;
+};
+
+struct RollbackSession {
+    Side localSide;
+    int inputDelay;           // Local input applies this many frames later
+    uint64_t seed;
+
+    World world;              // State at the start of 'frame'
+    uint32_t frame;           // Next frame to simulate
+    World snapshots[ROLLBACK_FRAMES + 1];
+
+    InputSlot local[INPUT_HISTORY];
+    InputSlot remote[INPUT_HISTORY];
+    uint32_t localFrame;      // Next frame a local input goes to
+    uint32_t confirmedFrame;  // Remote input known for every frame before this
+    uint32_t remoteAck;       // Remote has all our inputs before this
+    uint32_t rollbackFrame;   // Earliest misprediction, NO_ROLLBACK if none
+
+    // Desync detection: checksums of final (fully confirmed) states
+    uint32_t finalFrame;      // States up to here are final
+    uint32_t checksumFrames[CHECKSUM_HISTORY];
+    uint64_t checksums[CHECKSUM_HISTORY];
+    uint32_t lastChecksumFrame;
+    uint32_t remoteChecksumFrame;
+    uint64_t remoteChecksum;
+    int64_t desyncFrame;      // -1 if none
+
+    RollbackStats stats;
+};
+
+const uint32_t NO_ROLLBACK = 0xFFFFFFFFu;
+
+void InitRollback(RollbackSession& session, Side localSide, uint64_t seed, int subSteps, int inputDelay);
+
+// Once per frame: the local input, then AdvanceRollback. Advance returns
+// false (and simulates nothing) when it may not run further ahead of the
+// remote; the input is kept and the call is repeated next frame.
+bool AddLocalInput(RollbackSession& session, uint8_t input);
+void AddRemoteInput(RollbackSession& session, uint32_t frame, uint8_t input);
+bool AdvanceRollback(RollbackSession& session);
+
+uint64_t WorldChecksum(const World& world);
+
+// Wire format
+const int MAX_PACKET_INPUTS = 32;
+const int PACKET_HEADER_SIZE = 34;
+const int MAX_PACKET_SIZE = PACKET_HEADER_SIZE + MAX_PACKET_INPUTS / 4; // Header, then inputs at 2 bits each
+const int MAX_PACKET_SUB_STEPS = 255; // Sub-steps travel in one byte
+
+struct InputPacket {
+    uint64_t seed;            // Host's match seed; a joining side adopts it
+    uint8_t subSteps;         // Sender's World::subSteps; a joining side adopts them too
+    uint8_t physicsMode;      // Sender's PHYSICS_MODE; peers on different ones can't play
+    uint32_t startFrame;      // Frame of inputs[0]
+    uint32_t ackFrame;        // Sender has our inputs before this
+    uint32_t checksumFrame;
+    uint64_t checksum;
+    int count;
+    uint8_t inputs[MAX_PACKET_INPUTS];
+};
+
+void BuildInputPacket(const RollbackSession& session, InputPacket& packet);
+void ReceiveInputPacket(RollbackSession& session, const InputPacket& packet);
+int EncodeInputPacket(const InputPacket& packet, uint8_t* buffer); // Returns the size
+bool DecodeInputPacket(const uint8_t* buffer, int size, InputPacket& packet);
+
+#endif //PONG_ROLLBACK_H
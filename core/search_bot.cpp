@@ -0,0 +1,364 @@
+#include "search_bot.h"
+#include <chrono>
+#include <cmath>
+
+static const double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+// Paddle tops the play area allows
+const float PADDLE_TOP_MIN = PLAY_AREA_TOP;
+const float PADDLE_TOP_MAX = PLAY_AREA_BOTTOM - PADDLE_HEIGHT;
+
+// Leaf scoring: a receiver with this many pixels to spare is even money
+const float SLACK_SCALE = 100.0f;
+const float EXPLORATION = 0.7f;
+
+// The bot keeps this far from its paddle's ends, where a few pixels of
+// error in the prediction would be a miss
+const float SAFE_EDGE = 8.0f;
+
+// Paddle hits whose arrival height is within this of a child reuse its subtree
+const float SAME_SHOT = 6.0f;
+const float REUSE_SHOT = 24.0f;
+
+static float Clamp(float value, float low, float high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+// Height after travelling 'dy', bouncing off the top and bottom walls
+static float Fold(float y, float dy) {
+    const float low = PLAY_AREA_TOP + BALL_RADIUS;
+    const float span = (PLAY_AREA_BOTTOM - BALL_RADIUS) - low;
+    float folded = fmodf(y - low + dy, 2 * span);
+    if (folded < 0) folded += 2 * span;
+    if (folded > span) folded = 2 * span - folded;
+    return low + folded;
+}
+
+static void Reach(float y, float time, float& low, float& high) {
+    low = fmaxf(PADDLE_TOP_MIN, y - PLAYER_SPEED * time);
+    high = fminf(PADDLE_TOP_MAX, y + PLAYER_SPEED * time);
+}
+
+// Pixels of paddle travel the hitter has to spare; negative when it can't
+// get any part of the paddle to the ball
+static float Slack(const SearchNode& node) {
+    float low = Clamp(node.ballY - PADDLE_HEIGHT - BALL_RADIUS, PADDLE_TOP_MIN, PADDLE_TOP_MAX);
+    float high = Clamp(node.ballY + BALL_RADIUS, PADDLE_TOP_MIN, PADDLE_TOP_MAX);
+    float distance = node.hitterY < low ? low - node.hitterY : (node.hitterY > high ? node.hitterY - high : 0.0f);
+    return PLAYER_SPEED * node.hitterTime - distance;
+}
+
+// For the side that played the shot into this node: 1 = unreachable
+static float Evaluate(const SearchNode& node) {
+    float slack = Slack(node);
+    if (slack < 0) return 1.0f;
+    return SLACK_SCALE / (slack + SLACK_SCALE);
+}
+
+void InitSearchBot(SearchBot& bot) {
+    bot.nodes.assign((size_t)MAX_SEARCH_BLOCKS * SEARCH_BRANCHES, SearchNode{});
+    bot.freeBlocks.resize(MAX_SEARCH_BLOCKS);
+    bot.dropped.resize(MAX_SEARCH_BLOCKS);
+    bot.stats = {};
+    ResetSearchBot(bot);
+}
+
+void ResetSearchBot(SearchBot& bot) {
+    bot.hasRoot = false;
+    bot.root.children = -1;
+    bot.freeCount = MAX_SEARCH_BLOCKS;
+    bot.droppedCount = 0;
+    for (int i = 0; i < MAX_SEARCH_BLOCKS; i++) bot.freeBlocks[i] = MAX_SEARCH_BLOCKS - 1 - i;
+    bot.stats.blocksUsed = 0;
+}
+
+// Blocks of subtrees the root moved away from aren't swept up when it
+// moves, which could take longer than a frame's budget; they're reclaimed
+// one at a time when a fresh block is needed, their children's blocks
+// dropped in turn
+static void DropBlock(SearchBot& bot, int block) {
+    bot.dropped[bot.droppedCount++] = block;
+}
+
+static bool TakeBlock(SearchBot& bot, int& block) {
+    if (bot.freeCount > 0) {
+        block = bot.freeBlocks[--bot.freeCount];
+        return true;
+    }
+    if (bot.droppedCount == 0) return false;
+    block = bot.dropped[--bot.droppedCount];
+    const SearchNode* children = &bot.nodes[(size_t)block * SEARCH_BRANCHES];
+    for (int i = 0; i < SEARCH_BRANCHES; i++) {
+        if (children[i].children >= 0) DropBlock(bot, children[i].children);
+    }
+    return true;
+}
+
+static int BlocksUsed(const SearchBot& bot) {
+    return MAX_SEARCH_BLOCKS - bot.freeCount - bot.droppedCount;
+}
+
+// Children: the hitter meets the ball at each of SEARCH_BRANCHES points
+// along its paddle, or the nearest it can reach. 'grid' snaps paddle tops
+// to whole moves from hitterY, which the bot can then play exactly.
+static bool Expand(SearchBot& bot, SearchNode& node, bool grid) {
+    int block;
+    if (!TakeBlock(bot, block)) return false;
+    SearchNode* children = &bot.nodes[(size_t)block * SEARCH_BRANCHES];
+
+    float low;
+    float high;
+    Reach(node.hitterY, node.hitterTime, low, high);
+    Side receiver = node.hitter == RIGHT_SIDE ? LEFT_SIDE : RIGHT_SIDE;
+    float increase = 2.0f / node.currentSpeed; // As IncreaseSpeed
+    float speed = node.speed + increase;
+    float distance = bot.rightFace - bot.leftFace - 2; // Pushed off the paddle
+
+    float edge = node.hitter == RIGHT_SIDE ? SAFE_EDGE : 0.0f;
+    float spread = PADDLE_HEIGHT - 2 * edge;
+    int count = 0;
+    for (int i = 0; i < SEARCH_BRANCHES; i++) {
+        float paddle = Clamp(node.ballY - edge - spread * i / (SEARCH_BRANCHES - 1.0f), low, high);
+        if (grid) {
+            paddle = node.hitterY + PLAYER_SPEED * roundf((paddle - node.hitterY) / PLAYER_SPEED);
+            paddle = Clamp(paddle, PADDLE_TOP_MIN, PADDLE_TOP_MAX);
+        }
+        float dif = node.ballY - paddle;
+        if (dif < edge - BALL_RADIUS || dif > PADDLE_HEIGHT + BALL_RADIUS - edge) continue;
+        if (count > 0 && fabsf(children[count - 1].paddleY - paddle) < 1.0f) continue;
+
+        // Same deflection as move()
+        float hitPoint = Clamp(dif / PADDLE_HEIGHT, 0.0f, 1.0f);
+        double angle = (node.hitter == RIGHT_SIDE ? 255 - hitPoint * 150 : -75 + hitPoint * 150) * DEG_TO_RAD;
+        float velX = speed * (float)cos(angle);
+        float velY = speed * (float)sin(angle);
+        float flight = distance / fabsf(velX);
+        float reaction = receiver == LEFT_SIDE ? fminf(flight, (float)OPPONENT_REACTION_FRAMES) : 0.0f;
+
+        SearchNode& child = children[count++];
+        child = {};
+        child.ballY = Fold(node.ballY, velY * flight);
+        child.speed = speed;
+        child.currentSpeed = node.currentSpeed + increase;
+        child.hitterY = node.otherY;
+        child.hitterTime = node.otherTime + flight - reaction;
+        child.otherY = paddle;
+        child.otherTime = flight;
+        child.paddleY = paddle;
+        child.children = -1;
+        child.hitter = (uint8_t)receiver;
+        child.depth = node.depth + 1;
+    }
+
+    for (int i = count; i < SEARCH_BRANCHES; i++) children[i].children = -1; // Not dropped with the block
+    node.children = block;
+    node.childCount = (uint8_t)count;
+    bot.stats.blocksUsed = BlocksUsed(bot);
+    return true;
+}
+
+// Root children the bot's paddle can still get to this frame
+static bool Playable(const SearchBot& bot, const SearchNode& child) {
+    if (bot.root.hitter != RIGHT_SIDE) return true;
+    float low;
+    float high;
+    Reach(bot.root.hitterY, bot.root.hitterTime, low, high);
+    return child.paddleY >= low - PLAYER_SPEED / 2.0f && child.paddleY <= high + PLAYER_SPEED / 2.0f;
+}
+
+// One descent: pick children by UCT down to a leaf, grow it, score it and
+// pass the score back up, flipping sides at every contact
+static void Iterate(SearchBot& bot) {
+    SearchNode* path[MAX_SEARCH_DEPTH + 2];
+    int length = 0;
+    SearchNode* node = &bot.root;
+    path[length++] = node;
+
+    while (node->children >= 0 && node->childCount > 0) {
+        SearchNode* children = &bot.nodes[(size_t)node->children * SEARCH_BRANCHES];
+        float logVisits = logf((float)node->visits + 1.0f);
+        SearchNode* best = nullptr;
+        float bestScore = -1.0f;
+        for (int i = 0; i < node->childCount; i++) {
+            SearchNode& child = children[i];
+            if (node == &bot.root && !Playable(bot, child)) continue;
+            if (child.visits == 0) { best = &child; break; }
+            float score = child.value / child.visits + EXPLORATION * sqrtf(logVisits / child.visits);
+            if (score > bestScore) { bestScore = score; best = &child; }
+        }
+        if (!best) break;
+        node = best;
+        path[length++] = node;
+    }
+
+    // A leaf seen before gets its children; its first one is scored
+    if (node->visits > 0 && node->children < 0 && node->depth < MAX_SEARCH_DEPTH && Slack(*node) >= 0) {
+        bool grid = node == &bot.root && node->hitter == RIGHT_SIDE;
+        if (Expand(bot, *node, grid) && node->childCount > 0) {
+            node = &bot.nodes[(size_t)node->children * SEARCH_BRANCHES];
+            path[length++] = node;
+        }
+    }
+
+    float result = Evaluate(*node);
+    for (int i = length - 1; i >= 0; i--) {
+        path[i]->visits++;
+        path[i]->value += result;
+        result = 1.0f - result;
+    }
+}
+
+// The shot in flight, as a node: who meets it next, where and when
+static bool CurrentShot(const SearchBot& bot, const World& world, SearchNode& shot) {
+    Vector2 velocity = world.circle.center - world.OldPosition;
+    Vector2 ball = world.circle.center;
+    if (velocity.x == 0) return false; // Waiting for the serve
+
+    // Contact is found a step after the ball crosses the face, so a ball
+    // slightly past it is still being hit; one past the paddle is a point
+    float frames;
+    Side hitter;
+    if (velocity.x > 0) {
+        if (ball.x > bot.rightFace + PADDLE_WIDTH) return false;
+        frames = fmaxf(0.0f, (bot.rightFace - ball.x) / velocity.x);
+        hitter = RIGHT_SIDE;
+    } else {
+        if (ball.x < bot.leftFace - PADDLE_WIDTH) return false;
+        frames = fmaxf(0.0f, (ball.x - bot.leftFace) / -velocity.x);
+        hitter = LEFT_SIDE;
+    }
+
+    shot = {};
+    shot.ballY = Fold(ball.y, velocity.y * frames);
+    shot.speed = sqrtf(velocity.x * velocity.x + velocity.y * velocity.y);
+    shot.currentSpeed = world.currentSpeed;
+    shot.hitterY = hitter == RIGHT_SIDE ? world.bot.y : world.player.y;
+    shot.hitterTime = frames;
+    shot.otherY = hitter == RIGHT_SIDE ? world.player.y : world.bot.y;
+    shot.otherTime = frames;
+    shot.children = -1;
+    shot.hitter = (uint8_t)hitter;
+    return true;
+}
+
+// Keep the tree if this is the shot it was built for, or one of the
+// replies it explored; otherwise start again from 'shot'
+static void UpdateRoot(SearchBot& bot, const SearchNode& shot) {
+    SearchNode& root = bot.root;
+    bool same = bot.hasRoot && root.hitter == shot.hitter && fabsf(root.ballY - shot.ballY) < SAME_SHOT &&
+                fabsf(root.speed - shot.speed) < 0.01f;
+
+    if (!same && bot.hasRoot && root.hitter != shot.hitter && root.children >= 0) {
+        const SearchNode* children = &bot.nodes[(size_t)root.children * SEARCH_BRANCHES];
+        int match = -1;
+        float nearest = REUSE_SHOT;
+        for (int i = 0; i < root.childCount; i++) {
+            float distance = fabsf(children[i].ballY - shot.ballY);
+            if (distance < nearest && fabsf(children[i].speed - shot.speed) < 0.05f) {
+                nearest = distance;
+                match = i;
+            }
+        }
+        if (match >= 0) {
+            // The other replies go, and the block they shared with this one
+            for (int i = 0; i < root.childCount; i++) {
+                if (i != match && children[i].children >= 0) DropBlock(bot, children[i].children);
+            }
+            int block = root.children;
+            root = children[match];
+            bot.freeBlocks[bot.freeCount++] = block;
+            bot.stats.reusedShots++;
+            same = true;
+        }
+    }
+
+    if (!same) {
+        if (root.children >= 0) DropBlock(bot, root.children);
+        root = shot;
+        bot.hasRoot = true;
+        bot.stats.newShots++;
+    }
+
+    // What's known now replaces what was predicted
+    root.ballY = shot.ballY;
+    root.speed = shot.speed;
+    root.currentSpeed = shot.currentSpeed;
+    root.hitterY = shot.hitterY;
+    root.hitterTime = shot.hitterTime;
+    root.otherY = shot.otherY;
+    root.otherTime = shot.otherTime;
+    root.depth = 0;
+    bot.stats.blocksUsed = BlocksUsed(bot);
+}
+
+// Paddle top to head for: the most searched reachable hit when the ball is
+// coming, else the middle of the opponent's likely replies
+static float ChooseTarget(const SearchBot& bot) {
+    const SearchNode& root = bot.root;
+    const SearchNode* children = root.children >= 0 ? &bot.nodes[(size_t)root.children * SEARCH_BRANCHES] : nullptr;
+
+    if (root.hitter == RIGHT_SIDE) {
+        const SearchNode* best = nullptr;
+        for (int i = 0; children && i < root.childCount; i++) {
+            if (!Playable(bot, children[i])) continue;
+            if (!best || children[i].visits > best->visits) best = &children[i];
+        }
+        if (best) return best->paddleY;
+        return Clamp(root.ballY - PADDLE_HEIGHT / 2.0f, PADDLE_TOP_MIN, PADDLE_TOP_MAX);
+    }
+
+    float sum = 0.0f;
+    int visits = 0;
+    for (int i = 0; children && i < root.childCount; i++) {
+        sum += children[i].ballY * children[i].visits;
+        visits += children[i].visits;
+    }
+    float y = visits > 0 ? sum / visits : SCREEN_HEIGHT / 2.0f;
+    return Clamp(y - PADDLE_HEIGHT / 2.0f, PADDLE_TOP_MIN, PADDLE_TOP_MAX);
+}
+
+uint8_t ThinkSearchBot(SearchBot& bot, const World& world, int budgetMicros) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::microseconds(budgetMicros);
+
+    bot.leftFace = world.player.x + PADDLE_WIDTH + BALL_RADIUS;
+    bot.rightFace = world.bot.x - BALL_RADIUS;
+
+    float target = SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f;
+    int iterations = 0;
+    SearchNode shot;
+    if (CurrentShot(bot, world, shot)) {
+        UpdateRoot(bot, shot);
+        if (Slack(bot.root) >= 0) { // A lost point has nothing left to search
+            // Stop while the slowest iteration so far still fits
+            auto now = Clock::now();
+            auto slowest = Clock::duration::zero();
+            while (now + slowest < deadline) {
+                Iterate(bot);
+                iterations++;
+                auto after = Clock::now();
+                if (after - now > slowest) slowest = after - now;
+                now = after;
+            }
+        }
+        target = ChooseTarget(bot);
+    } else {
+        bot.hasRoot = false;
+    }
+
+    SearchStats& stats = bot.stats;
+    double micros = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    stats.thinks++;
+    stats.iterations += iterations;
+    stats.lastIterations = iterations;
+    stats.lastMicros = micros;
+    stats.totalMicros += micros;
+    if (micros > stats.maxMicros) stats.maxMicros = micros;
+    if (micros > budgetMicros) stats.overruns++;
+
+    float dif = target - world.bot.y;
+    if (dif > PLAYER_SPEED / 2.0f) return INPUT_BOT_DOWN;
+    if (dif < -PLAYER_SPEED / 2.0f) return INPUT_BOT_UP;
+    return 0;
+}
@@ -0,0 +1,78 @@
+#ifndef PONG_SEARCH_BOT_H
+#define PONG_SEARCH_BOT_H
+
+#include <vector>
+#include "core.h"
+
+// Expert bot: an anytime tree search over where to meet the ball.
+// Every paddle contact is a node; its children are the hit points the
+// hitter can still reach, and a hit point fixes the return angle, speed and
+// where the ball arrives on the other side. The search (UCT) prefers shots
+// that leave the opponent too little time to get there, looking several
+// contacts ahead. It runs for a fixed time every frame and keeps its tree
+// while the shot lasts and, when the hit was one it had looked at, across
+// the hit too.
+//
+// The bot plays the right paddle of an EXPERT world through the input bits
+// (INPUT_BOT_*), so replays record its moves and don't depend on its timing.
+
+const int DEFAULT_SEARCH_BUDGET_US = 200;
+const int SEARCH_BRANCHES = 12;          // Hit points tried at each contact
+const int MAX_SEARCH_BLOCKS = 4096;      // Sets of SEARCH_BRANCHES children, allocated once
+const int MAX_SEARCH_DEPTH = 12;         // Contacts looked ahead
+const int OPPONENT_REACTION_FRAMES = SIM_HZ / 5; // Before the opponent follows a shot (200 ms)
+
+struct SearchNode {
+    float ballY;        // Ball center when it meets the hitter's paddle
+    float speed;        // Arriving ball speed, px per frame
+    float currentSpeed; // World::currentSpeed at the hit
+    float hitterY;      // The hitter's paddle top is within hitterTime * PLAYER_SPEED of this
+    float hitterTime;
+    float otherY;       // Same for the other paddle
+    float otherTime;
+    float paddleY;      // Paddle top the previous hitter played this shot from
+    float value;        // Results for the previous hitter, 0..1 per visit
+    int visits;
+    int children;       // Block index, -1 until expanded
+    uint8_t childCount;
+    uint8_t hitter;     // Side
+    uint8_t depth;
+};
+
+struct SearchStats {
+    long thinks;
+    long overruns;        // Thinks that took longer than their budget
+    long iterations;
+    int lastIterations;
+    double lastMicros;
+    double maxMicros;
+    double totalMicros;
+    long reusedShots;     // Paddle hits the tree had already explored
+    long newShots;        // Shots searched from scratch
+    int blocksUsed;
+};
+
+struct SearchBot {
+    SearchNode root;
+    bool hasRoot;
+    float leftFace;  // Ball center x where it meets each paddle
+    float rightFace;
+
+    // Node pool, sized once so thinking never allocates
+    std::vector<SearchNode> nodes; // MAX_SEARCH_BLOCKS * SEARCH_BRANCHES
+    std::vector<int> freeBlocks;
+    int freeCount;
+    std::vector<int> dropped; // Roots of subtrees no longer searched, not yet reclaimed
+    int droppedCount;
+
+    SearchStats stats;
+};
+
+void InitSearchBot(SearchBot& bot);
+void ResetSearchBot(SearchBot& bot); // Drop the tree, e.g. for a new match
+
+// Search for up to budgetMicros, then the right paddle's INPUT_BOT_* bits
+// for the next StepWorld
+uint8_t ThinkSearchBot(SearchBot& bot, const World& world, int budgetMicros);
+
+#endif //PONG_SEARCH_BOT_H
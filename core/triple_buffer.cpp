@@ -0,0 +1,36 @@
+#include "triple_buffer.h"
+
+void InitTripleBuffer(TripleBuffer& buffer) {
+    buffer.back = 0;
+    buffer.middle.store(1, std::memory_order_relaxed);
+    buffer.front = 2;
+    buffer.published.store(0, std::memory_order_relaxed);
+    buffer.dropped.store(0, std::memory_order_relaxed);
+    buffer.reads = 0;
+    buffer.repeats = 0;
+}
+
+uint32_t WriteSlot(const TripleBuffer& buffer) {
+    return buffer.back;
+}
+
+void PublishSlot(TripleBuffer& buffer) {
+    // Release: the slot's contents before the index; acquire: the reader is
+    // done with the slot we get back
+    uint32_t previous = buffer.middle.exchange(buffer.back | TRIPLE_BUFFER_FRESH, std::memory_order_acq_rel);
+    if (previous & TRIPLE_BUFFER_FRESH) buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    buffer.back = previous & ~TRIPLE_BUFFER_FRESH;
+    buffer.published.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t ReadSlot(TripleBuffer& buffer) {
+    buffer.reads++;
+    // Only the writer sets the fresh bit, so seeing it here means the swap gets a new one
+    if (buffer.middle.load(std::memory_order_relaxed) & TRIPLE_BUFFER_FRESH) {
+        uint32_t previous = buffer.middle.exchange(buffer.front, std::memory_order_acq_rel);
+        buffer.front = previous & ~TRIPLE_BUFFER_FRESH;
+    } else {
+        buffer.repeats++;
+    }
+    return buffer.front;
+}
@@ -0,0 +1,35 @@
+#ifndef PONG_TRIPLE_BUFFER_H
+#define PONG_TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free triple buffer: one writer hands whole snapshots to one reader
+// through three slots the caller owns. The writer fills its back slot and
+// publishes it, swapping it with the middle one; the reader swaps the
+// middle slot for its front one whenever a new snapshot is there. Neither
+// side ever waits: the writer overwrites a snapshot the reader didn't get
+// to, and the reader keeps the last one until a newer one arrives.
+
+const uint32_t TRIPLE_BUFFER_FRESH = 4; // In 'middle': published, not read yet
+
+struct TripleBuffer {
+    std::atomic<uint32_t> middle; // Slot index, plus TRIPLE_BUFFER_FRESH
+    uint32_t back;                // Writer's slot
+    uint32_t front;               // Reader's slot
+
+    std::atomic<uint64_t> published; // Writer's counters, readable anywhere
+    std::atomic<uint64_t> dropped;   // Replaced before the reader got them
+    uint64_t reads;                  // Reader's own
+    uint64_t repeats;                // Reads with nothing new: the same snapshot again
+};
+
+// Slot 0 is the writer's, slot 2 the reader's; fill all three before the
+// reader starts so it always has something to show
+void InitTripleBuffer(TripleBuffer& buffer);
+
+uint32_t WriteSlot(const TripleBuffer& buffer); // Writer: the slot to fill
+void PublishSlot(TripleBuffer& buffer);         // Writer: hand it over
+uint32_t ReadSlot(TripleBuffer& buffer);        // Reader: the newest slot
+
+#endif //PONG_TRIPLE_BUFFER_H
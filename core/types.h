@@ -0,0 +1,52 @@
+#ifndef PONG_TYPES_H
+#define PONG_TYPES_H
+
+// The simulation shares raylib's plain math structs so the game can pass
+// them straight through. When raylib.h is included first its definitions
+// win, otherwise we declare identical copies here (same trick as raymath.h).
+// Always include raylib.h BEFORE any core header.
+
+#if !defined(RL_VECTOR2_TYPE)
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+#define RL_VECTOR2_TYPE
+#endif
+
+#if !defined(RL_RECTANGLE_TYPE)
+typedef struct Rectangle {
+    float x;
+    float y;
+    float width;
+    float height;
+} Rectangle;
+#define RL_RECTANGLE_TYPE
+#endif
+
+#if !defined(RL_COLOR_TYPE)
+typedef struct Color {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+} Color;
+#define RL_COLOR_TYPE
+#endif
+
+// Operator overloads
+inline bool operator==(const Vector2& v1, const Vector2& v2) {
+    return (v1.x == v2.x) && (v1.y == v2.y);
+}
+inline Vector2 operator+(const Vector2& v1, const Vector2& v2) {
+    return {v1.x + v2.x, v1.y + v2.y};
+}
+inline Vector2 operator-(const Vector2& v1, const Vector2& v2) {
+    return {v1.x - v2.x, v1.y - v2.y};
+}
+inline void operator*=(Vector2& v, float x) {
+    v.x *= x;
+    v.y *= x;
+}
+
+#endif //PONG_TYPES_H
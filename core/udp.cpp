@@ -0,0 +1,102 @@
+#include "udp.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static bool StartNetworking() {
+#ifdef _WIN32
+    static bool started = false;
+    if (!started) {
+        WSADATA data;
+        started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+    return started;
+#else
+    return true;
+#endif
+}
+
+bool OpenUdpSocket(UdpSocket& sock, uint16_t port) {
+    sock.handle = -1;
+    if (!StartNetworking()) return false;
+
+#ifdef _WIN32
+    SOCKET handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == INVALID_SOCKET) return false;
+#else
+    int handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle < 0) return false;
+#endif
+    sock.handle = (intptr_t)handle;
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    bool ok = bind(handle, (const sockaddr*)&address, sizeof(address)) == 0;
+
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ok = ok && ioctlsocket(handle, FIONBIO, &nonBlocking) == 0;
+#else
+    ok = ok && fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    if (!ok) CloseUdpSocket(sock);
+    return ok;
+}
+
+void CloseUdpSocket(UdpSocket& sock) {
+    if (sock.handle < 0) return;
+#ifdef _WIN32
+    closesocket((SOCKET)sock.handle);
+#else
+    close((int)sock.handle);
+#endif
+    sock.handle = -1;
+}
+
+bool ResolveAddress(const char* host, uint16_t port, NetAddress& address) {
+    if (!StartNetworking()) return false;
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &result) != 0 || !result) return false;
+    address.ip = ((const sockaddr_in*)result->ai_addr)->sin_addr.s_addr;
+    address.port = htons(port);
+    freeaddrinfo(result);
+    return true;
+}
+
+bool SendDatagram(UdpSocket& sock, const NetAddress& to, const uint8_t* data, int size) {
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = to.ip;
+    address.sin_port = to.port;
+    return sendto(sock.handle, (const char*)data, size, 0, (const sockaddr*)&address, sizeof(address)) == size;
+}
+
+int ReceiveDatagram(UdpSocket& sock, NetAddress& from, uint8_t* buffer, int capacity) {
+    sockaddr_in address = {};
+    socklen_t length = sizeof(address);
+    int size = (int)recvfrom(sock.handle, (char*)buffer, capacity, 0, (sockaddr*)&address, &length);
+    if (size < 0) return -1;
+    from.ip = address.sin_addr.s_addr;
+    from.port = address.sin_port;
+    return size;
+}
+
+bool SameAddress(const NetAddress& a, const NetAddress& b) {
+    return a.ip == b.ip && a.port == b.port;
+}
@@ -0,0 +1,25 @@
+#ifndef PONG_UDP_H
+#define PONG_UDP_H
+
+#include <cstdint>
+
+// Minimal non-blocking UDP sockets (BSD sockets / Winsock)
+
+struct NetAddress {
+    uint32_t ip;   // Network byte order
+    uint16_t port; // Network byte order
+};
+
+struct UdpSocket {
+    intptr_t handle; // -1 when closed
+};
+
+bool OpenUdpSocket(UdpSocket& sock, uint16_t port); // 0 = any free port
+void CloseUdpSocket(UdpSocket& sock);
+bool ResolveAddress(const char* host, uint16_t port, NetAddress& address);
+bool SendDatagram(UdpSocket& sock, const NetAddress& to, const uint8_t* data, int size);
+// Size of the datagram, or -1 when nothing is waiting
+int ReceiveDatagram(UdpSocket& sock, NetAddress& from, uint8_t* buffer, int capacity);
+bool SameAddress(const NetAddress& a, const NetAddress& b);
+
+#endif //PONG_UDP_H
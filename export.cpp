@@ -0,0 +1,145 @@
+// pong_export - render a match to video without a window, as fast as it goes
+//
+//   pong_export --out FILE.y4m|DIR [--replay FILE] [--left BOT] [--right BOT]
+//               [--seed S] [--fps N] [--width N] [--height N]
+//               [--threads N] [--max-seconds N]
+//
+// Without --replay two bots (easy, medium or hard; default hard against
+// medium) play a match. The video shows the match at normal speed and
+// --fps frames per second, whatever the rendering speed; particles are on,
+// sound isn't. Y4M plays in ffplay/mpv or goes straight into ffmpeg.
+
+#include <raylib.h>
+#include "particles.h"
+#include "render.h"
+#include "replay.h"
+#include "video.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+static bool ParseBot(const char* name, BotFunction& bot) {
+    if (strcmp(name, "easy") == 0) bot = BotForDifficulty(EASY);
+    else if (strcmp(name, "medium") == 0) bot = BotForDifficulty(MEDIUM);
+    else if (strcmp(name, "hard") == 0) bot = BotForDifficulty(HARD);
+    else return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* out = nullptr;
+    const char* replayPath = nullptr;
+    BotFunction left = BotForDifficulty(HARD);
+    BotFunction right = BotForDifficulty(MEDIUM);
+    uint64_t seed = 1;
+    int fps = 60;
+    int width = SCREEN_WIDTH;
+    int height = SCREEN_HEIGHT;
+    int threads = (int)std::thread::hardware_concurrency() - 1;
+    int maxSeconds = 600; // Bots that never miss would play forever
+
+    for (int i = 1; i < argc; i++) {
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--out") == 0 && next) out = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && next) replayPath = argv[++i];
+        else if (strcmp(argv[i], "--left") == 0 && next && ParseBot(next, left)) i++;
+        else if (strcmp(argv[i], "--right") == 0 && next && ParseBot(next, right)) i++;
+        else if (strcmp(argv[i], "--seed") == 0 && next) seed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--fps") == 0 && next) fps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--width") == 0 && next) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--height") == 0 && next) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && next) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-seconds") == 0 && next) maxSeconds = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!out) {
+        fprintf(stderr, "--out FILE.y4m or DIR is required\n");
+        return 1;
+    }
+    if (fps < 1) fps = 1;
+
+    World world;
+    ReplayPlayer replay = {};
+    if (replayPath) {
+        if (!OpenReplay(replay, replayPath)) {
+            fprintf(stderr, "Could not open replay %s\n", replayPath);
+            return 1;
+        }
+        world = replay.world;
+    } else {
+        ResetWorld(world, EASY, seed);
+    }
+    World previous = world;
+
+    // A GL context is all the window is for
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(320, 180, "pong_export");
+    LoadRenderCache();
+
+    VideoExport video;
+    if (!StartVideoExport(video, out, width, height, fps, threads)) {
+        fprintf(stderr, "Could not start the export to %s\n", out);
+        CloseWindow();
+        return 1;
+    }
+
+    ParticlePool particles;
+    InitParticlePool(particles, DEFAULT_MAX_PARTICLES);
+    Rng particleRng;
+    SeedRng(particleRng, seed);
+
+    // Whole simulation steps per video frame, the rest blended like the game does
+    const double stepsPerFrame = (double)SIM_HZ / fps;
+    const long maxSteps = (long)maxSeconds * SIM_HZ;
+    double accumulator = 0.0;
+    long steps = 0;
+    bool over = false;
+    double start = GetTime();
+
+    while (!over) {
+        accumulator += stepsPerFrame;
+        while (accumulator >= 1.0 && !over) {
+            accumulator -= 1.0;
+            previous = world;
+            UpdateParticles(particles, 1.0f / SIM_HZ);
+            if (replayPath) {
+                over = !StepReplay(replay);
+                if (!over) world = replay.world;
+            } else {
+                StepWorldBots(world, left, right);
+                over = IsMatchOver(world);
+            }
+            SpawnEventParticles(particles, particleRng, world.events);
+            steps++;
+            if (steps >= maxSteps) over = true;
+        }
+
+        BeginVideoFrame(video);
+        ClearBackground(BG_COLOR);
+        DrawMatch(previous, world, (float)accumulator);
+        DrawParticles(particles);
+        EndVideoFrame(video);
+    }
+    FinishVideoExport(video);
+    double seconds = GetTime() - start;
+
+    const VideoStats& stats = video.stats;
+    double videoSeconds = (double)stats.frames / fps;
+    printf("%ld frames (%.1f s of video, %dx%d at %d fps) in %.2f s: %.1f fps, %.1fx real time\n", stats.frames,
+           videoSeconds, video.width, video.height, fps, seconds, stats.frames / seconds, videoSeconds / seconds);
+    printf("Final score %d - %d\n", world.playerScore, world.botScore);
+    printf("Readback %.2f s on the main thread, %ld waits for the encoders; encode %.2f s, write %.2f s on workers\n",
+           stats.readSeconds, stats.queueWaits, stats.encodeSeconds, stats.writeSeconds);
+    if (stats.bytes > 0) printf("%.1f MB written to %s\n", stats.bytes / (1024.0 * 1024.0), out);
+    if (stats.failures > 0) fprintf(stderr, "%ld frames could not be written\n", stats.failures);
+
+    CloseReplay(replay);
+    UnloadRenderCache();
+    CloseWindow();
+    return stats.failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+#include "latency.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// Sleeping is only good to a millisecond or so; the rest is spun
+const double SPIN_TIME = 0.002;
+
+void InitFramePacer(FramePacer& pacer, int fps, double renderAhead) {
+    pacer.period = fps > 0 ? 1.0 / fps : 0.0;
+    pacer.renderAhead = renderAhead;
+    pacer.next = 0.0;
+}
+
+void WaitForNextFrame(FramePacer& pacer) {
+    if (pacer.period <= 0.0) return;
+    double now = GetTime();
+    // First frame, or too far behind to catch up
+    if (pacer.next == 0.0 || now - pacer.next > pacer.period) pacer.next = now;
+
+    double remaining = pacer.next - now;
+    if (remaining > SPIN_TIME) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(remaining - SPIN_TIME));
+    }
+    while (GetTime() < pacer.next) {
+    }
+
+    if (pacer.renderAhead <= 0.0) pacer.next += pacer.period;
+}
+
+void FramePresented(FramePacer& pacer) {
+    // With vsync EndDrawing returns at the vblank; start the next frame just
+    // early enough to make the following one
+    if (pacer.renderAhead > 0.0) pacer.next = GetTime() + pacer.period - pacer.renderAhead;
+}
+
+// Every key the game reacts to with IsKeyPressed
+const int LATCHED_KEYS[] = {KEY_ESCAPE, KEY_ENTER, KEY_F3, KEY_F11, KEY_SPACE, KEY_LEFT, KEY_RIGHT, KEY_UP, KEY_DOWN};
+const int LATCHED_KEY_COUNT = sizeof(LATCHED_KEYS) / sizeof(LATCHED_KEYS[0]);
+
+static bool latchedKeys[LATCHED_KEY_COUNT];
+static bool latchedMouse;
+
+void LatePollInput() {
+    for (int i = 0; i < LATCHED_KEY_COUNT; i++) latchedKeys[i] = IsKeyPressed(LATCHED_KEYS[i]);
+    latchedMouse = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+    PollInputEvents();
+}
+
+bool KeyPressed(int key) {
+    if (IsKeyPressed(key)) return true;
+    for (int i = 0; i < LATCHED_KEY_COUNT; i++) {
+        if (LATCHED_KEYS[i] == key) return latchedKeys[i];
+    }
+    return false;
+}
+
+bool MousePressed(int button) {
+    return IsMouseButtonPressed(button) || (button == MOUSE_LEFT_BUTTON && latchedMouse);
+}
+
+void NoteKeyDown(LatencyStats& stats) {
+    if (stats.pressTime != 0.0) return; // Still measuring the last one
+    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_DOWN)) {
+        stats.pressTime = GetTime();
+        stats.pressApplied = false;
+    }
+}
+
+void NoteInputApplied(LatencyStats& stats) {
+    if (stats.pressTime != 0.0) stats.pressApplied = true;
+}
+
+void NoteFramePresented(LatencyStats& stats) {
+    if (stats.pressTime == 0.0) return;
+    if (!stats.pressApplied) {
+        // Pressed outside of a match
+        if (GetTime() - stats.pressTime > 0.5) stats.pressTime = 0.0;
+        return;
+    }
+    stats.samples[stats.count % LATENCY_SAMPLES] = (float)((GetTime() - stats.pressTime) * 1000.0);
+    stats.count++;
+    stats.pressTime = 0.0;
+}
+
+float LatencyPercentile(const LatencyStats& stats, float percentile) {
+    static float sorted[LATENCY_SAMPLES];
+    int n = std::min(stats.count, LATENCY_SAMPLES);
+    if (n == 0) return 0.0f;
+    std::copy(stats.samples, stats.samples + n, sorted);
+    int k = std::min(n - 1, (int)(percentile / 100.0f * n));
+    std::nth_element(sorted, sorted + k, sorted + n);
+    return sorted[k];
+}
@@ -0,0 +1,44 @@
+#ifndef PONG_LATENCY_H
+#define PONG_LATENCY_H
+
+#include <raylib.h>
+
+// Low-latency mode: raylib's own frame cap sleeps inside EndDrawing, right
+// after input was polled, so every frame shows input that is a whole sleep
+// old. Instead the cap is turned off, we wait for the next frame here
+// (sleep most of the way, spin the rest), poll input again and only then
+// simulate and draw.
+
+struct FramePacer {
+    double period;      // Seconds per frame
+    double renderAhead; // With vsync: start this long before the next vblank, 0 = pace by the clock
+    double next;        // When the next frame should start
+};
+
+void InitFramePacer(FramePacer& pacer, int fps, double renderAhead);
+void WaitForNextFrame(FramePacer& pacer);
+void FramePresented(FramePacer& pacer); // Right after EndDrawing
+
+// Polling a second time in a frame would lose the key presses the first
+// poll (inside EndDrawing) saw, so those are latched first.
+void LatePollInput();
+bool KeyPressed(int key);
+bool MousePressed(int button);
+
+// Key-down to present: from the poll that first sees UP/DOWN go down to
+// the EndDrawing of the first frame simulated with it
+const int LATENCY_SAMPLES = 1024;
+
+struct LatencyStats {
+    float samples[LATENCY_SAMPLES]; // Milliseconds, ring
+    int count;                      // Total recorded
+    double pressTime;               // Pending press, 0 = none
+    bool pressApplied;
+};
+
+void NoteKeyDown(LatencyStats& stats);      // After polling
+void NoteInputApplied(LatencyStats& stats); // A step consumed the input
+void NoteFramePresented(LatencyStats& stats);
+float LatencyPercentile(const LatencyStats& stats, float percentile);
+
+#endif //PONG_LATENCY_H
@@ -1,600 +1,757 @@
 #include <raylib.h>
-#include <cmath>
+#include "alloc.h"
+#include "assets.h"
+#include "audio.h"
+#include "chaos.h"
+#include "core.h"
+#include "latency.h"
+#include "netplay.h"
+#include "particles.h"
+#include "profiler.h"
+#include "render.h"
+#include "replay.h"
+#include "search_bot.h"
+#include "sim_thread.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <time.h>
-#include <vector>
-
-// Constants
-const int SCREEN_WIDTH = 1600;
-const int SCREEN_HEIGHT = 900;
-const int BORDER_THICKNESS = 40; // Decorative border
-const int PLAY_AREA_TOP = BORDER_THICKNESS;
-const int PLAY_AREA_BOTTOM = SCREEN_HEIGHT - BORDER_THICKNESS;
-const int PADDLE_WIDTH = 20;
-const int PADDLE_HEIGHT = 200;
-const int BALL_RADIUS = 20;
-const float BALL_SPEED = 4.0f;
-const int WIN_SCORE = 10;
-
-enum Collisions {
-    NO_COL,
-    LOWER_BORDER,
-    UPPER_BORDER,
-    LEFT_BORDER,
-    RIGHT_BORDER,
-    PLAYER_COL,
-    BOT_COL,
-};
 
 enum GameState {
     MENU,
     GAME,
     OVER,
+    REPLAY,
+    NETPLAY,
+    CHAOS,
 };
 
-enum Difficulty {
-    EASY,
-    MEDIUM,
-    HARD,
-};
-
-struct Circle {
-    Vector2 center;
-    Collisions Collision;
-};
-
-struct Button {
-    Rectangle rect;
-    const char* text;
-    Color normalColor;
-    Color hoverColor;
-    bool isHovered;
+// Command line options
+struct Options {
+    int maxParticles = DEFAULT_MAX_PARTICLES;
+    int particleStress = 0; // Keep this many particles alive while playing
+    int subSteps = 1;       // Ball updates per frame
+    int targetFps = 120;    // Render cap, 0 = uncapped
+    const char* recordDir = nullptr;  // Save every match here
+    const char* replayPath = nullptr; // Play this file instead of the menu
+    bool lowLatency = false;          // Own frame pacing, input polled right before simulating
+    float renderAheadMs = 0.0f;       // Vsync on, start each frame this long before the vblank
+    bool latencyStats = false;        // Show key-down to present percentiles
+    const char* profileCsv = nullptr;   // Every profiler zone sample, written on the fly
+    const char* profileTrace = nullptr; // Same as a Chrome trace
+    int hostPort = 0;                   // Wait for a two-player match on this port
+    const char* joinAddress = nullptr;  // host:port of a match to join
+    int inputDelay = 2;                 // Netplay frames of local input delay
+    int chaosBalls = DEFAULT_CHAOS_BALLS;
+    int voices = DEFAULT_VOICES;        // Overlapping plays per sound effect
+    int searchBudget = DEFAULT_SEARCH_BUDGET_US; // Expert bot's thinking per frame, microseconds
+    float renderScale = 1.0f;           // Of the window's pixels; the most dynamic resolution uses
+    bool dynamicResolution = false;     // Lower the render scale while frames run over budget
+    int allocCheck = 0;                 // Seconds of hands-free matches that must not allocate, 0 = off
+    bool simThread = false;             // Single-player matches step on a thread of their own
 };
 
-struct Particle {
-    Vector2 position;
-    Vector2 velocity;
-    float lifetime;
-    Color color;
-};
-
-// Color scheme - Cyberpunk vibes!
-const Color BG_COLOR = Color{10, 10, 30, 255};
-const Color PADDLE_COLOR = Color{0, 255, 200, 255};
-const Color BALL_COLOR = Color{255, 50, 150, 255};
-const Color UI_COLOR = Color{100, 200, 255, 150};
-const Color ACCENT_COLOR = Color{255, 100, 255, 255};
-
 // Particle system
-std::vector<Particle> particles;
-
-void SpawnParticles(Vector2 position, Color color, int count) {
-    for (int i = 0; i < count; i++) {
-        Particle p;
-        p.position = position;
-        float angle = GetRandomValue(0, 360) * DEG2RAD;
-        float speed = GetRandomValue(50, 200);
-        p.velocity = {(float)cos(angle) * speed,(float) sin(angle) * speed};
-        p.lifetime = GetRandomValue(20, 60) / 60.0f;
-        p.color = color;
-        particles.push_back(p);
-    }
-}
-
-void UpdateParticles(float deltaTime) {
-    for (auto it = particles.begin(); it != particles.end();) {
-        it->lifetime -= deltaTime;
-        if (it->lifetime <= 0) {
-            it = particles.erase(it);
-        } else {
-            it->position.x += it->velocity.x * deltaTime;
-            it->position.y += it->velocity.y * deltaTime;
-            it->velocity.x *= 0.95f;
-            it->velocity.y *= 0.95f;
-            ++it;
-        }
-    }
-}
-
-void DrawParticles() {
-    for (const auto& p : particles) {
-        float alpha = p.lifetime;
-        DrawCircleV(p.position, 3, ColorAlpha(p.color, alpha));
-    }
-}
-
-// Operator overloads
-inline bool operator==(const Vector2& v1, const Vector2& v2) {
-    return (v1.x == v2.x) && (v2.y == v2.y);
-}
-inline Vector2 operator+(const Vector2& v1, const Vector2& v2) {
-    return {v1.x + v2.x, v1.y + v2.y};
-}
-inline Vector2 operator-(const Vector2& v1, const Vector2& v2) {
-    return {v1.x - v2.x, v1.y - v2.y};
-}
-inline void operator*=(Vector2& v, float x) {
-    v.x *= x;
-    v.y *= x;
-}
-
-// Collision detection
-void CircleCollideWith(Circle& circle, Rectangle player, Rectangle bot) {
-    if (circle.center.x < BALL_RADIUS) { circle.Collision = LEFT_BORDER; return; }
-    if (circle.center.x > SCREEN_WIDTH - BALL_RADIUS) { circle.Collision = RIGHT_BORDER; return; }
-    if (circle.center.y < PLAY_AREA_TOP + BALL_RADIUS) { circle.Collision = UPPER_BORDER; return; }
-    if (circle.center.y > PLAY_AREA_BOTTOM - BALL_RADIUS) { circle.Collision = LOWER_BORDER; return; }
-    if (CheckCollisionCircleRec(circle.center, BALL_RADIUS, player)) { circle.Collision = PLAYER_COL; return; }
-    if (CheckCollisionCircleRec(circle.center, BALL_RADIUS, bot)) { circle.Collision = BOT_COL; return; }
-    circle.Collision = NO_COL;
-}
+ParticlePool particles;
+Rng particleRng;
 
-void CircleCollideWith(Circle& circle) {
-    if (circle.center.x < BALL_RADIUS) { circle.Collision = LEFT_BORDER; return; }
-    if (circle.center.x > SCREEN_WIDTH - BALL_RADIUS) { circle.Collision = RIGHT_BORDER; return; }
-    if (circle.center.y < PLAY_AREA_TOP + BALL_RADIUS) { circle.Collision = UPPER_BORDER; return; }
-    if (circle.center.y > PLAY_AREA_BOTTOM - BALL_RADIUS) { circle.Collision = LOWER_BORDER; return; }
-    circle.Collision = NO_COL;
-}
+// Sound effects, one voice pool each once the sounds are in
+VoicePool paddleVoices;
+VoicePool wallVoices;
+VoicePool scoreVoices;
 
-Vector2 randomDirection(float dep) {
-    int x = GetRandomValue(120, 240);
-    double deg = (double)x * PI / 180.0;
-    return {dep * (float)cos(deg), dep * (float)sin(deg)};
-}
-
-bool withinHigh(Rectangle rec) {
-    return rec.y > PLAY_AREA_TOP;
-}
-
-bool withinLow(Rectangle rec) {
-    return (rec.y + rec.height) < PLAY_AREA_BOTTOM;
-}
-
-Circle PointOfCollision(Circle circle, Vector2 oldPosition) {
-    Vector2 Velocity = circle.center - oldPosition;
-    CircleCollideWith(circle);
-    while (circle.Collision == NO_COL) {
-        circle.center = circle.center + Velocity;
-        CircleCollideWith(circle);
-    }
-    return circle;
-}
-
-void IncreaseSpeed(Circle circle, Vector2& Velocity, float& currentSpeed) {
-    if (circle.Collision == PLAYER_COL || circle.Collision == BOT_COL) {
-        float speed = sqrt(pow(Velocity.x, 2) + pow(Velocity.y, 2));
-        float increase = 2.0f / currentSpeed; // Logarithmic increase
-        Velocity.x += (increase * Velocity.x) / speed;
-        Velocity.y += (increase * Velocity.y) / speed;
-        currentSpeed += increase;
-    }
+// UI Functions
+bool IsButtonClicked(Button& button, Vector2 mousePos) {
+    button.isHovered = CheckCollisionPointRec(mousePos, button.rect);
+    return button.isHovered && MousePressed(MOUSE_LEFT_BUTTON);
 }
 
-Circle RightBorderCollision(Circle circle, Vector2 oldPosition) {
-    Circle futureCollision = PointOfCollision(circle, oldPosition);
-    Vector2 Velocity = circle.center - oldPosition;
-    int bounceCount = 0;
-    while (futureCollision.Collision != RIGHT_BORDER && bounceCount < 10) {
-        if (futureCollision.Collision == UPPER_BORDER || futureCollision.Collision == LOWER_BORDER) {
-            Velocity.y = -Velocity.y;
-            futureCollision = PointOfCollision({futureCollision.center + Velocity, NO_COL}, futureCollision.center);
-            bounceCount++;
-        } else {
-            break;
+// Turn simulation events into sound and particles
+void PlayEvents(const EventList& events) {
+    for (int i = 0; i < events.count; i++) {
+        switch (events.items[i].type) {
+            case WALL_HIT: PlayVoice(wallVoices); break;
+            case PADDLE_HIT: PlayVoice(paddleVoices); break;
+            case SCORE: PlayVoice(scoreVoices); break;
         }
     }
-    return futureCollision;
+    SpawnEventParticles(particles, particleRng, events);
 }
 
-int move(Circle& circle, Vector2& OldPosition, float dep, Rectangle player, Rectangle bot, float& currentSpeed, Sound paddleHit, Sound wallHit) {
-    int score = 0;
-    Vector2 Velocity;
-
-    if (OldPosition == circle.center) {
-        Velocity = randomDirection(dep);
-        OldPosition = circle.center;
-        circle.center = circle.center + Velocity;
-        return 0;
-    }
-
-    CircleCollideWith(circle, player, bot);
-
-    switch (circle.Collision) {
-        case NO_COL: {
-            Velocity = circle.center - OldPosition;
-            break;
-        }
-        case UPPER_BORDER:
-        case LOWER_BORDER: {
-            PlaySound(wallHit);
-            SpawnParticles(circle.center, PADDLE_COLOR, 8);
-            Velocity.x = circle.center.x - OldPosition.x;
-            Velocity.y = OldPosition.y - circle.center.y;
-
-            // Push ball away from border
-            if (circle.Collision == UPPER_BORDER) circle.center.y = PLAY_AREA_TOP + BALL_RADIUS + 2;
-            else circle.center.y = PLAY_AREA_BOTTOM - BALL_RADIUS - 2;
-            break;
-        }
-        case BOT_COL: {
-            PlaySound(paddleHit);
-            SpawnParticles(circle.center, BALL_COLOR, 12);
-            Velocity = circle.center - OldPosition;
-            float speed = sqrt(pow(Velocity.x, 2) + pow(Velocity.y, 2));
-            float dif = circle.center.y - bot.y;
-            float hitPoint = dif / PADDLE_HEIGHT;
-            if (hitPoint < 0) hitPoint = 0;
-            if (hitPoint > 1) hitPoint = 1;
-            // FIXED: Y grows DOWN, so angles need to be inverted
-            // hitPoint 0 (top) should send ball UP (negative Y velocity)
-            // hitPoint 1 (bottom) should send ball DOWN (positive Y velocity)
-            double angle = (255 - (hitPoint * 150)) * (PI / 180.0); // Inverted from 255° to 105°
-            Velocity.x = speed * (float)cos(angle);
-            Velocity.y = speed * (float)sin(angle);
-
-            // Push ball away from paddle to prevent multi-collision
-            circle.center.x = bot.x - BALL_RADIUS - 2;
-
-            score = 1;
-            break;
-        }
-        case PLAYER_COL: {
-            PlaySound(paddleHit);
-            SpawnParticles(circle.center, BALL_COLOR, 12);
-            Velocity = circle.center - OldPosition;
-            float speed = sqrt(pow(Velocity.x, 2) + pow(Velocity.y, 2));
-            float dif = circle.center.y - player.y;
-            float hitPoint = dif / PADDLE_HEIGHT;
-            if (hitPoint < 0) hitPoint = 0;
-            if (hitPoint > 1) hitPoint = 1;
-            // FIXED: Y grows DOWN, so angles need to be inverted
-            // hitPoint 0 (top) should send ball UP (negative Y velocity)
-            // hitPoint 1 (bottom) should send ball DOWN (positive Y velocity)
-            double angle = (-75 + (hitPoint * 150)) * (PI / 180.0); // From -75° to 75°
-            Velocity.x = speed * (float)cos(angle);
-            Velocity.y = speed * (float)sin(angle);
-
-            // Push ball away from paddle
-            circle.center.x = player.x + PADDLE_WIDTH + BALL_RADIUS + 2;
-
-            score = 1;
-            break;
+Options ParseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--max-particles") == 0 && next) {
+            options.maxParticles = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--particle-stress") == 0) {
+            options.particleStress = 100000;
+            if (next && next[0] != '-') options.particleStress = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--substeps") == 0 && next) {
+            options.subSteps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fps") == 0 && next) {
+            options.targetFps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--record") == 0 && next) {
+            options.recordDir = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && next) {
+            options.replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--low-latency") == 0) {
+            options.lowLatency = true;
+        } else if (strcmp(argv[i], "--render-ahead") == 0 && next) {
+            options.renderAheadMs = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--latency-stats") == 0) {
+            options.latencyStats = true;
+        } else if (strcmp(argv[i], "--profile-csv") == 0 && next) {
+            options.profileCsv = argv[++i];
+        } else if (strcmp(argv[i], "--profile-trace") == 0 && next) {
+            options.profileTrace = argv[++i];
+        } else if (strcmp(argv[i], "--host") == 0 && next) {
+            options.hostPort = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--join") == 0 && next) {
+            options.joinAddress = argv[++i];
+        } else if (strcmp(argv[i], "--input-delay") == 0 && next) {
+            options.inputDelay = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--chaos-balls") == 0 && next) {
+            options.chaosBalls = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--voices") == 0 && next) {
+            options.voices = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--search-budget") == 0 && next) {
+            options.searchBudget = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--render-scale") == 0 && next) {
+            options.renderScale = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--dynamic-resolution") == 0) {
+            options.dynamicResolution = true;
+        } else if (strcmp(argv[i], "--alloc-check") == 0) {
+            options.allocCheck = 60;
+            if (next && next[0] != '-') options.allocCheck = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sim-thread") == 0) {
+            options.simThread = true;
         }
     }
-
-    IncreaseSpeed(circle, Velocity, currentSpeed);
-    OldPosition = circle.center;
-    circle.center = circle.center + Velocity;
-    return score;
+    if (options.maxParticles < options.particleStress) options.maxParticles = options.particleStress;
+    if (options.renderAheadMs > 0.0f) options.lowLatency = true;
+    if (options.searchBudget < 1) options.searchBudget = 1;
+    if (options.renderScale < MIN_RENDER_SCALE) options.renderScale = MIN_RENDER_SCALE;
+    if (options.renderScale > 1.0f) options.renderScale = 1.0f;
+    return options;
 }
 
-void moveBotEasy(Rectangle& bot, Vector2 circle) {
-    float botCenterLine = bot.y + PADDLE_HEIGHT / 2;
-    if ((circle.y > botCenterLine) && withinLow(bot)) {
-        bot.y += 5;
-    }
-    if (circle.y < botCenterLine && withinHigh(bot)) {
-        bot.y -= 5;
+// Stress mode: top the pool up from random points every frame
+void StressParticles(int target) {
+    while (particles.count < target && particles.count < particles.capacity) {
+        Vector2 position = {(float)RandomValue(particleRng, 0, SCREEN_WIDTH), (float)RandomValue(particleRng, PLAY_AREA_TOP, PLAY_AREA_BOTTOM)};
+        SpawnParticles(particles, particleRng, position, RandomValue(particleRng, 0, 1) ? PADDLE_COLOR : BALL_COLOR, 30);
     }
 }
 
-void moveBotMedium(Rectangle& bot, Circle circle, Vector2 oldPosition, Circle& futureCollision) {
-    if (circle.Collision == PLAYER_COL || circle.Collision == UPPER_BORDER || circle.Collision == LOWER_BORDER) {
-        futureCollision = PointOfCollision(circle, oldPosition);
-    }
-
-    if (futureCollision.Collision != RIGHT_BORDER) {
-        moveBotEasy(bot, circle.center);
-    } else {
-        float botCenterLine = bot.y + PADDLE_HEIGHT / 2;
-        if ((futureCollision.center.y > botCenterLine) && withinLow(bot)) {
-            bot.y += 5;
-        }
-        if (futureCollision.center.y < botCenterLine && withinHigh(bot)) {
-            bot.y -= 5;
-        }
-    }
-}
-
-void moveBotHard(Rectangle& bot, Circle circle, Vector2 oldPosition, Circle& futureCollision) {
-    if (circle.Collision == PLAYER_COL) {
-        futureCollision = RightBorderCollision(circle, oldPosition);
-    }
-    float botCenterLine = bot.y + PADDLE_HEIGHT / 2;
-    if ((futureCollision.center.y > botCenterLine) && withinLow(bot)) {
-        bot.y += 7;
-    }
-    if (futureCollision.center.y < botCenterLine && withinHigh(bot)) {
-        bot.y -= 7;
-    }
+// Allocation check autopilot: follow the ball with the player's paddle,
+// loosely enough that the expert bot still scores now and then
+uint8_t AutopilotInput(const World& world) {
+    float center = world.player.y + world.player.height / 2;
+    if (world.circle.center.y < center - 30) return INPUT_UP;
+    if (world.circle.center.y > center + 30) return INPUT_DOWN;
+    return 0;
 }
 
-// Draw rounded paddle with glow
-void DrawRoundedPaddle(Rectangle rec, Color color) {
-    // Glow effect
-    DrawRectangleGradientEx(
-        {rec.x - 8, rec.y - 8, rec.width + 16, rec.height + 16},
-        ColorAlpha(color, 0), ColorAlpha(color, 0.1f),
-        ColorAlpha(color, 0.1f), ColorAlpha(color, 0)
-    );
-
-    // Main paddle body with rounded corners
-    DrawRectangleRounded(rec, 0.5f, 10, color);
-
-    // Bright center line
-    DrawRectangleRounded({rec.x + rec.width/2 - 2, rec.y + 5, 4, rec.height - 10},
-                         0.5f, 5, ColorAlpha(WHITE, 0.5f));
+// Input latency
+LatencyStats latency;
+
+// Chaos mode, allocated when it starts
+ChaosWorld chaos;
+
+// Expert bot's search tree
+SearchBot searchBot;
+
+// Single-player matches with --sim-thread, and what the render thread has
+// taken from its snapshots so far
+SimThread sim;
+long simWallHits = 0;
+long simPaddleHits = 0;
+long simScores = 0;
+uint64_t simAllocations = 0;
+
+// Play the sounds for every event since the last snapshot drawn, including
+// the ones in snapshots that were never drawn
+void PlaySimEvents(const SimSnapshot& snapshot) {
+    for (; simWallHits < snapshot.wallHits; simWallHits++) PlayVoice(wallVoices);
+    for (; simPaddleHits < snapshot.paddleHits; simPaddleHits++) PlayVoice(paddleVoices);
+    for (; simScores < snapshot.scores; simScores++) PlayVoice(scoreVoices);
 }
 
-// Draw ball with glow and trail
-void DrawGlowBall(Vector2 pos, float radius, Color color) {
-    // Outer glow layers
-    for (int i = 3; i > 0; i--) {
-        float glowRadius = radius + (i * 5);
-        float alpha = 0.15f / i;
-        DrawCircleV(pos, glowRadius, ColorAlpha(color, alpha));
-    }
-
-    // Main ball
-    DrawCircleV(pos, radius, color);
-
-    // Highlight
-    DrawCircleV({pos.x - 5, pos.y - 5}, radius / 3, ColorAlpha(WHITE, 0.6f));
+void StopSimMatch() {
+    if (!sim.thread.joinable()) return;
+    StopSimThread(sim);
+    TraceLog(LOG_INFO, "Sim thread: %llu steps, %llu never drawn, %llu of %llu frames repeated a step",
+             (unsigned long long)sim.buffer.published.load(), (unsigned long long)sim.buffer.dropped.load(),
+             (unsigned long long)sim.buffer.repeats, (unsigned long long)sim.buffer.reads);
 }
 
-// UI Functions
-bool IsButtonClicked(Button& button, Vector2 mousePos) {
-    button.isHovered = CheckCollisionPointRec(mousePos, button.rect);
-    return button.isHovered && IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+// Replays
+ReplayWriter recorder;
+bool recording = false;
+
+void SaveRecording(const char* dir) {
+    if (!recording) return;
+    recording = false;
+    static int matchNumber = 0;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/pong-%lld-%d.replay", dir, (long long)time(NULL), matchNumber++);
+    if (SaveReplay(recorder, path)) TraceLog(LOG_INFO, "Replay saved to %s", path);
+    else TraceLog(LOG_WARNING, "Could not save replay to %s", path);
 }
 
-void DrawButton(Button button) {
-    Color color = button.isHovered ? button.hoverColor : button.normalColor;
+// Every screen draws in logical coordinates into the frame target
+FrameTarget frameTarget;
+float renderScale = 1.0f;
 
-    // Glow on hover
-    if (button.isHovered) {
-        DrawRectangleRounded({button.rect.x - 5, button.rect.y - 5, button.rect.width + 10, button.rect.height + 10},
-                             0.3f, 10, ColorAlpha(button.hoverColor, 0.3f));
-    }
+// Heap allocations the main thread made last frame
+uint64_t frameAllocations = 0;
 
-    // Button
-    DrawRectangleRounded(button.rect, 0.3f, 10, color);
-    DrawRectangleRoundedLines(button.rect, 0.3f, 10, ColorAlpha(WHITE, 0.8f));
-
-    int textWidth = MeasureText(button.text, 30);
-    DrawText(button.text,
-             button.rect.x + (button.rect.width - textWidth) / 2,
-             button.rect.y + 18,
-             30, WHITE);
-}
-
-void DrawMenu() {
-    DrawText("P O N G", SCREEN_WIDTH / 2 - 200, 150, 100, ACCENT_COLOR);
-    DrawText("Choose Your Difficulty", SCREEN_WIDTH / 2 - 200, 280, 30, UI_COLOR);
+void BeginFrame() {
+    BeginFrameTarget(frameTarget, renderScale);
 }
 
-void DrawGameUI(int playerScore, int botScore) {
-    // Draw decorative borders
-    // Top border
-    DrawRectangleGradientV(0, 0, SCREEN_WIDTH, BORDER_THICKNESS,
-                           ColorAlpha(ACCENT_COLOR, 0.3f), ColorAlpha(ACCENT_COLOR, 0.1f));
-    DrawRectangle(0, BORDER_THICKNESS - 3, SCREEN_WIDTH, 3, ACCENT_COLOR);
-
-    // Bottom border
-    DrawRectangleGradientV(0, PLAY_AREA_BOTTOM, SCREEN_WIDTH, BORDER_THICKNESS,
-                           ColorAlpha(ACCENT_COLOR, 0.1f), ColorAlpha(ACCENT_COLOR, 0.3f));
-    DrawRectangle(0, PLAY_AREA_BOTTOM, SCREEN_WIDTH, 3, ACCENT_COLOR);
-
-    // Decorative corner accents
-    DrawCircle(40, BORDER_THICKNESS / 2, 5, PADDLE_COLOR);
-    DrawCircle(SCREEN_WIDTH - 40, BORDER_THICKNESS / 2, 5, PADDLE_COLOR);
-    DrawCircle(40, PLAY_AREA_BOTTOM + BORDER_THICKNESS / 2, 5, PADDLE_COLOR);
-    DrawCircle(SCREEN_WIDTH - 40, PLAY_AREA_BOTTOM + BORDER_THICKNESS / 2, 5, PADDLE_COLOR);
-
-    // Dashed center line (only in play area)
-    for (int i = PLAY_AREA_TOP; i < PLAY_AREA_BOTTOM; i += 30) {
-        DrawRectangle(SCREEN_WIDTH / 2 - 3, i, 6, 20, ColorAlpha(UI_COLOR, 0.3f));
+void PresentFrame(bool showProfiler) {
+    if (showProfiler) {
+        DrawProfilerOverlay();
+        DrawText(TextFormat("Render %dx%d (%.0f%%)", frameTarget.width, frameTarget.height, renderScale * 100),
+                 SCREEN_WIDTH - 300, SCREEN_HEIGHT - 30, 20, ColorAlpha(WHITE, 0.8f));
+        const char* heap = TextFormat("Heap: %llu last frame | %llu allocations, %.1f MB", (unsigned long long)frameAllocations,
+                                      (unsigned long long)AllocationCount(), AllocatedBytes() / (1024.0 * 1024.0));
+        DrawText(heap, SCREEN_WIDTH - 10 - MeasureText(heap, 20), SCREEN_HEIGHT - 55, 20, ColorAlpha(WHITE, 0.8f));
+        if (sim.thread.joinable()) {
+            const char* steps = TextFormat("Sim thread: %llu steps | %llu never drawn | %llu repeated",
+                                           (unsigned long long)sim.buffer.published.load(std::memory_order_relaxed),
+                                           (unsigned long long)sim.buffer.dropped.load(std::memory_order_relaxed),
+                                           (unsigned long long)sim.buffer.repeats);
+            DrawText(steps, SCREEN_WIDTH - 10 - MeasureText(steps, 20), SCREEN_HEIGHT - 80, 20, ColorAlpha(WHITE, 0.8f));
+        }
     }
-
-    // Scores with glow
-    DrawText(TextFormat("%d", playerScore), SCREEN_WIDTH / 2 - 100, BORDER_THICKNESS + 10, 60, ColorAlpha(PADDLE_COLOR, 0.8f));
-    DrawText(TextFormat("%d", botScore), SCREEN_WIDTH / 2 + 60, BORDER_THICKNESS + 10, 60, ColorAlpha(PADDLE_COLOR, 0.8f));
-
-    // FPS
-    DrawText(TextFormat("FPS: %d", GetFPS()), 10, 10, 20, ColorAlpha(WHITE, 0.5f));
-
-    // Instructions
-    DrawText("F11 - Fullscreen | ESC - Menu", SCREEN_WIDTH - 350, 10, 20, ColorAlpha(WHITE, 0.5f));
+    PROFILE_ZONE(ZONE_PRESENT);
+    EndFrameTarget(frameTarget);
+    EndDrawing();
 }
 
-void DrawGameOver(int playerScore, int botScore) {
-    // Overlay
-    DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, ColorAlpha(BLACK, 0.7f));
-
-    if (playerScore >= WIN_SCORE) {
-        DrawText("YOU WIN!", SCREEN_WIDTH / 2 - 250, 250, 100, PADDLE_COLOR);
-    } else {
-        DrawText("YOU LOSE!", SCREEN_WIDTH / 2 - 280, 250, 100, BALL_COLOR);
+// Stats under a single-player match
+void DrawMatchStats(const Options& options, double particleTime, Difficulty difficulty, const SearchStats& search) {
+    if (options.particleStress > 0) {
+        DrawText(TextFormat("Particles: %d | Update: %.3f ms", particles.count, particleTime * 1000.0),
+                 10, SCREEN_HEIGHT - 30, 20, ColorAlpha(WHITE, 0.8f));
+    }
+    if (options.latencyStats) {
+        DrawText(TextFormat("Input latency p50: %.1f ms | p99: %.1f ms | %d presses",
+                            LatencyPercentile(latency, 50), LatencyPercentile(latency, 99), latency.count),
+                 10, SCREEN_HEIGHT - 55, 20, ColorAlpha(WHITE, 0.8f));
+        DrawText(TextFormat("Audio latency p50: %.1f ms | p99: %.1f ms | %d sounds",
+                            AudioLatencyPercentile(50), AudioLatencyPercentile(99), AudioLatencyCount()),
+                 10, SCREEN_HEIGHT - 80, 20, ColorAlpha(WHITE, 0.8f));
+        if (difficulty == EXPERT) {
+            DrawText(TextFormat("Search: %.0f us (max %.0f, budget %d) | %d iterations | tree %d%% | %ld over budget",
+                                search.lastMicros, search.maxMicros, options.searchBudget, search.lastIterations,
+                                search.blocksUsed * 100 / MAX_SEARCH_BLOCKS, search.overruns),
+                     10, SCREEN_HEIGHT - 105, 20, ColorAlpha(WHITE, 0.8f));
+        }
     }
-
-    DrawText(TextFormat("Final Score: %d - %d", playerScore, botScore),
-             SCREEN_WIDTH / 2 - 220, 400, 40, WHITE);
-    DrawText("Press ENTER to return to menu", SCREEN_WIDTH / 2 - 280, 550, 30, UI_COLOR);
-    DrawText("Press ESC to quit", SCREEN_WIDTH / 2 - 150, 600, 25, ColorAlpha(WHITE, 0.7f));
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // Startup: the icon and sounds decode on a worker from here on, the window
+    // comes up meanwhile and the audio device only after the first frame
+    auto launch = std::chrono::steady_clock::now();
+    auto sinceLaunch = [launch]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launch).count();
+    };
+    StartLoadingAssets();
+    GameSounds sounds = {};
+    bool firstFrame = true;
+
+    Options options = ParseOptions(argc, argv);
+
+    if (options.renderAheadMs > 0.0f) SetConfigFlags(FLAG_VSYNC_HINT);
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Pong");
-    SetTargetFPS(120);
-    SetRandomSeed(time(NULL));
 
-    // Load icon
-    Image icon = LoadImage("C:/Users/youss/Pictures/Pong2.png");
-    SetWindowIcon(icon);
-    UnloadImage(icon);
-
-    // Initialize audio
-    InitAudioDevice();
-    Sound paddleHit = LoadSound("sounds/paddle_hit.wav");
-    Sound wallHit = LoadSound("sounds/wall_hit.wav");
-    Sound scoreSound = LoadSound("sounds/score.wav");
+    // Low-latency mode paces frames itself; with render-ahead, at the display
+    // rate. So does dynamic resolution, to time a frame's work without
+    // raylib's frame cap sleep in it.
+    bool ownPacing = options.lowLatency || options.dynamicResolution;
+    SetTargetFPS(ownPacing ? 0 : options.targetFps);
+    FramePacer pacer;
+    int pacedFps = options.renderAheadMs > 0.0f ? GetMonitorRefreshRate(GetCurrentMonitor()) : options.targetFps;
+    InitFramePacer(pacer, pacedFps, options.renderAheadMs / 1000.0);
+
+    ResolutionController resolution;
+    InitResolutionController(resolution, 1.0 / (pacedFps > 0 ? pacedFps : 60), options.renderScale);
+    renderScale = resolution.scale;
+
+    InitProfiler(options.profileCsv, options.profileTrace);
+    bool showProfiler = false;
+    SetRandomSeed(time(NULL));
+    SeedRng(particleRng, (uint64_t)time(NULL));
+    InitParticlePool(particles, options.maxParticles);
+    if (options.simThread) InitSimThread(sim, options.maxParticles, (uint64_t)time(NULL) + 1);
+    InitSearchBot(searchBot);
+    LoadRenderCache();
 
     GameState state = MENU;
-    Difficulty difficulty = EASY;
-
-    Circle circle = {{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, NO_COL};
-    Rectangle player = {10, SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f, PADDLE_WIDTH, PADDLE_HEIGHT};
-    Rectangle bot = {SCREEN_WIDTH - 30.0f, SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f, PADDLE_WIDTH, PADDLE_HEIGHT};
-    Vector2 OldPosition = circle.center;
-    Circle futureCollision = circle;
+    World world;
+    ResetWorld(world, EASY, (uint64_t)time(NULL));
+    World previous = world;
+    Rectangle chaosPlayer = {};
+    Rectangle chaosBot = {};
+
+    ReplayPlayer replay = {};
+    bool replayPaused = false;
+    if (options.replayPath) {
+        if (OpenReplay(replay, options.replayPath)) {
+            world = previous = replay.world;
+            state = REPLAY;
+        } else {
+            TraceLog(LOG_WARNING, "Could not open replay %s", options.replayPath);
+        }
+    }
 
-    int playerScore = 0;
-    int botScore = 0;
-    float currentSpeed = BALL_SPEED;
+    // Two players over the network, the remote one on the other paddle
+    Netplay net = {};
+    bool netOk = true;
+    if (options.hostPort > 0) netOk = HostNetplay(net, (uint16_t)options.hostPort, options.subSteps, options.inputDelay);
+    else if (options.joinAddress) netOk = JoinNetplay(net, options.joinAddress, options.subSteps, options.inputDelay);
+    if (!netOk) TraceLog(LOG_WARNING, "Could not start netplay");
+    if (net.active) state = NETPLAY;
+
+    // Fixed-step clock: the simulation (and particles) advance in whole steps
+    // of 1 / SIM_HZ whatever the display does, and rendering blends between
+    // the last two states
+    const double step = 1.0 / SIM_HZ;
+    const double MAX_FRAME_TIME = 0.25; // Don't try to catch up after a stall
+    double accumulator = 0.0;
+
+    // Allocation check: play matches by themselves and fail on any heap
+    // allocation in a GAME frame once startup is over
+    double allocCheckSeconds = 0.0;
+    long allocCheckFrames = 0;
+    bool allocCheckFailed = false;
 
     while (!WindowShouldClose()) {
-        // Fullscreen toggle
-        if (IsKeyPressed(KEY_F11)) {
-            ToggleFullscreen();
+        if (ownPacing) {
+            PROFILE_ZONE(ZONE_WAIT);
+            WaitForNextFrame(pacer);
+        }
+        double frameStart = GetTime();
+        uint64_t frameAllocStart = ThreadAllocationCount();
+        uint64_t simFrameAllocations = 0; // The sim thread's, over the steps this frame shows
+        bool steadyFrame = state == GAME && sounds.loaded;
+        if (options.lowLatency) {
+            PROFILE_ZONE(ZONE_INPUT);
+            LatePollInput();
+            NoteKeyDown(latency);
         }
 
-        float deltaTime = GetFrameTime();
-        UpdateParticles(deltaTime);
+        // Fullscreen at the desktop resolution; the frame target letterboxes
+        if (KeyPressed(KEY_F11)) {
+            ToggleBorderlessWindowed();
+        }
+        if (KeyPressed(KEY_F3)) showProfiler = !showProfiler;
+
+        double frameTime = GetFrameTime();
+        if (frameTime > MAX_FRAME_TIME) frameTime = MAX_FRAME_TIME;
+        accumulator += frameTime;
+        int steps = 0;
+        while (accumulator >= step) {
+            accumulator -= step;
+            steps++;
+        }
+
+        double updateStart = GetTime();
+        {
+            PROFILE_ZONE(ZONE_PARTICLES);
+            for (int i = 0; i < steps; i++) {
+                UpdateParticles(particles, (float)step);
+            }
+        }
+        double particleTime = GetTime() - updateStart;
 
         switch (state) {
             case MENU: {
                 Vector2 mousePos = GetMousePosition();
 
-                Button easyBtn = {{550, 380, 500, 70}, "EASY - Reactive Bot", Color{0, 100, 0, 255}, PADDLE_COLOR, false};
-                Button mediumBtn = {{550, 470, 500, 70}, "MEDIUM - Predictive Bot", Color{180, 100, 0, 255}, Color{255, 200, 0, 255}, false};
-                Button hardBtn = {{550, 560, 500, 70}, "HARD - Perfect Prediction", Color{100, 0, 100, 255}, ACCENT_COLOR, false};
-
-                if (IsButtonClicked(easyBtn, mousePos)) {
-                    difficulty = EASY;
-                    state = GAME;
-                    playerScore = 0;
-                    botScore = 0;
-                    currentSpeed = BALL_SPEED;
-                    circle = {{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, NO_COL};
-                    OldPosition = circle.center;
-                    player.y = SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f;
-                    bot.y = SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f;
-                    particles.clear();
-                }
-                if (IsButtonClicked(mediumBtn, mousePos)) {
-                    difficulty = MEDIUM;
+                // Built once; only their hover state changes
+                static Button easyBtn = {{550, 380, 500, 70}, "EASY - Reactive Bot", Color{0, 100, 0, 255}, PADDLE_COLOR, false};
+                static Button mediumBtn = {{550, 470, 500, 70}, "MEDIUM - Predictive Bot", Color{180, 100, 0, 255}, Color{255, 200, 0, 255}, false};
+                static Button hardBtn = {{550, 560, 500, 70}, "HARD - Perfect Prediction", Color{100, 0, 100, 255}, ACCENT_COLOR, false};
+                static Button expertBtn = {{550, 650, 500, 70}, "EXPERT - Search Bot", Color{20, 40, 120, 255}, Color{120, 170, 255, 255}, false};
+                static Button chaosBtn = {{550, 740, 500, 70}, "CHAOS - Party Mode", Color{120, 20, 60, 255}, BALL_COLOR, false};
+
+                bool start = false;
+                Difficulty difficulty = EASY;
+                if (IsButtonClicked(easyBtn, mousePos)) { difficulty = EASY; start = true; }
+                if (IsButtonClicked(mediumBtn, mousePos)) { difficulty = MEDIUM; start = true; }
+                if (IsButtonClicked(hardBtn, mousePos)) { difficulty = HARD; start = true; }
+                if (IsButtonClicked(expertBtn, mousePos)) { difficulty = EXPERT; start = true; }
+                if (options.allocCheck > 0) { difficulty = EXPERT; start = true; }
+                if (start) {
+                    uint64_t seed = (uint64_t)time(NULL);
+                    ResetWorld(world, difficulty, seed);
+                    world.subSteps = options.subSteps;
+                    ResetSearchBot(searchBot);
+                    previous = world;
+                    if (options.recordDir) {
+                        BeginReplay(recorder, world, seed);
+                        recording = true;
+                    }
                     state = GAME;
-                    playerScore = 0;
-                    botScore = 0;
-                    currentSpeed = BALL_SPEED;
-                    circle = {{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, NO_COL};
-                    OldPosition = circle.center;
-                    player.y = SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f;
-                    bot.y = SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f;
-                    particles.clear();
+                    ClearParticles(particles);
+                    if (options.simThread) {
+                        simWallHits = simPaddleHits = simScores = 0;
+                        simAllocations = 0;
+                        StartSimThread(sim, world, searchBot, options.searchBudget, recording ? &recorder : nullptr);
+                    }
                 }
-                if (IsButtonClicked(hardBtn, mousePos)) {
-                    difficulty = HARD;
-                    state = GAME;
-                    playerScore = 0;
-                    botScore = 0;
-                    currentSpeed = BALL_SPEED;
-                    circle = {{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, NO_COL};
-                    OldPosition = circle.center;
-                    player.y = SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f;
-                    bot.y = SCREEN_HEIGHT / 2.0f - PADDLE_HEIGHT / 2.0f;
-                    particles.clear();
+                if (IsButtonClicked(chaosBtn, mousePos)) {
+                    InitChaos(chaos, options.chaosBalls, (uint64_t)time(NULL));
+                    chaosPlayer = chaos.player;
+                    chaosBot = chaos.bot;
+                    state = CHAOS;
+                    ClearParticles(particles);
                 }
 
-                BeginDrawing();
+                BeginFrame();
                 ClearBackground(BG_COLOR);
                 DrawMenu();
                 DrawButton(easyBtn);
                 DrawButton(mediumBtn);
                 DrawButton(hardBtn);
-                DrawParticles();
-                EndDrawing();
+                DrawButton(expertBtn);
+                DrawButton(chaosBtn);
+                DrawParticles(particles);
+                PresentFrame(showProfiler);
                 break;
             }
 
             case GAME: {
-                // Player controls
-                if (IsKeyDown(KEY_UP) && withinHigh(player)) {
-                    player.y -= 7;
+                if (options.simThread) {
+                    // The newest step there is, whatever the sim thread is doing now
+                    const SimSnapshot& snapshot = LatestSimSnapshot(sim);
+                    {
+                        PROFILE_ZONE(ZONE_INPUT);
+                        uint8_t input = 0;
+                        if (IsKeyDown(KEY_UP)) input |= INPUT_UP;
+                        if (IsKeyDown(KEY_DOWN)) input |= INPUT_DOWN;
+                        if (options.allocCheck > 0) input = AutopilotInput(snapshot.world);
+                        SetSimInput(sim, input);
+                    }
+                    bool quit = KeyPressed(KEY_ESCAPE);
+                    PlaySimEvents(snapshot);
+                    if (snapshot.input) NoteInputApplied(latency);
+                    simFrameAllocations = snapshot.allocations - simAllocations;
+                    simAllocations = snapshot.allocations;
+                    if (options.particleStress > 0) StressParticles(options.particleStress);
+
+                    float alpha = (float)((SimClock() - snapshot.stepTime) / step);
+                    BeginFrame();
+                    ClearBackground(BG_COLOR);
+                    DrawMatch(snapshot.previous, snapshot.world, alpha < 1.0f ? alpha : 1.0f);
+                    DrawParticles(snapshot.particles);
+                    DrawParticles(particles);
+                    DrawMatchStats(options, particleTime, snapshot.world.difficulty, snapshot.search);
+                    PresentFrame(showProfiler);
+
+                    // Once the frame is out: stopping waits for the step in progress
+                    if (quit) {
+                        StopSimMatch();
+                        state = MENU;
+                        ClearParticles(particles);
+                        SaveRecording(options.recordDir);
+                    } else if (snapshot.over) {
+                        StopSimMatch();
+                        world = previous = snapshot.world;
+                        CopyParticles(particles, snapshot.particles);
+                        state = OVER;
+                        SaveRecording(options.recordDir);
+                    }
+                    break;
                 }
-                if (IsKeyDown(KEY_DOWN) && withinLow(player)) {
-                    player.y += 7;
+
+                // Player controls
+                uint8_t input = 0;
+                {
+                    PROFILE_ZONE(ZONE_INPUT);
+                    if (IsKeyDown(KEY_UP)) input |= INPUT_UP;
+                    if (IsKeyDown(KEY_DOWN)) input |= INPUT_DOWN;
+                    if (options.allocCheck > 0) input = AutopilotInput(world);
                 }
 
                 // ESC to menu
-                if (IsKeyPressed(KEY_ESCAPE)) {
+                if (KeyPressed(KEY_ESCAPE)) {
                     state = MENU;
-                    particles.clear();
+                    ClearParticles(particles);
+                    SaveRecording(options.recordDir);
                 }
 
-                // Check for scoring BEFORE moving
-                CircleCollideWith(circle, player, bot);
-                if (circle.Collision == LEFT_BORDER) {
-                    PlaySound(scoreSound);
-                    botScore++;
-                    SpawnParticles({50, SCREEN_HEIGHT / 2.0f}, BALL_COLOR, 30);
-                    circle = {{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, NO_COL};
-                    OldPosition = circle.center;
-                    currentSpeed = BALL_SPEED;
+                // Game logic
+                for (int i = 0; i < steps && state == GAME; i++) {
+                    previous = world;
+                    // The expert bot's budget is per rendered frame, shared by its steps
+                    uint8_t stepInput = input;
+                    if (world.difficulty == EXPERT) {
+                        PROFILE_ZONE(ZONE_SEARCH);
+                        stepInput |= ThinkSearchBot(searchBot, world, options.searchBudget / steps);
+                    }
+                    if (recording) RecordReplayFrame(recorder, world, stepInput);
+                    if (input) NoteInputApplied(latency);
+                    StepWorld(world, stepInput);
+                    PlayEvents(world.events);
+
+                    // Win condition
+                    if (IsMatchOver(world)) {
+                        state = OVER;
+                        SaveRecording(options.recordDir);
+                    }
                 }
-                if (circle.Collision == RIGHT_BORDER) {
-                    PlaySound(scoreSound);
-                    playerScore++;
-                    SpawnParticles({SCREEN_WIDTH - 50, SCREEN_HEIGHT / 2.0f}, PADDLE_COLOR, 30);
-                    circle = {{SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f}, NO_COL};
-                    OldPosition = circle.center;
-                    currentSpeed = BALL_SPEED;
+                if (options.particleStress > 0) StressParticles(options.particleStress);
+
+                BeginFrame();
+                ClearBackground(BG_COLOR);
+                DrawMatch(previous, world, (float)(accumulator / step));
+                DrawParticles(particles);
+                DrawMatchStats(options, particleTime, world.difficulty, searchBot.stats);
+                PresentFrame(showProfiler);
+                break;
+            }
+
+            case OVER: {
+                // Keep the remote fed until it has seen the end too
+                for (int i = 0; i < steps && net.active; i++) {
+                    ReceiveNetplay(net);
+                    SendNetplay(net);
                 }
 
-                // Win condition
-                if (playerScore >= WIN_SCORE || botScore >= WIN_SCORE) {
-                    state = OVER;
+                if (KeyPressed(KEY_ENTER) || options.allocCheck > 0) {
+                    state = MENU;
+                    ClearParticles(particles);
+                    CloseNetplay(net);
                 }
 
-                // Game logic
-                move(circle, OldPosition, BALL_SPEED, player, bot, currentSpeed, paddleHit, wallHit);
+                BeginFrame();
+                ClearBackground(BG_COLOR);
+                if (net.started && net.session.localSide == RIGHT_SIDE) DrawGameOver(world.botScore, world.playerScore);
+                else DrawGameOver(world.playerScore, world.botScore);
+                DrawParticles(particles);
+                PresentFrame(showProfiler);
+                break;
+            }
 
-                if (difficulty == EASY) moveBotEasy(bot, circle.center);
-                else if (difficulty == MEDIUM) moveBotMedium(bot, circle, OldPosition, futureCollision);
-                else moveBotHard(bot, circle, OldPosition, futureCollision);
+            case NETPLAY: {
+                uint8_t input = 0;
+                {
+                    PROFILE_ZONE(ZONE_INPUT);
+                    if (IsKeyDown(KEY_UP)) input |= INPUT_UP;
+                    if (IsKeyDown(KEY_DOWN)) input |= INPUT_DOWN;
+                }
+
+                if (KeyPressed(KEY_ESCAPE)) {
+                    CloseNetplay(net);
+                    state = MENU;
+                    ClearParticles(particles);
+                }
 
-                BeginDrawing();
+                // A step that has to wait for the remote simulates nothing
+                for (int i = 0; i < steps && state == NETPLAY; i++) {
+                    ReceiveNetplay(net);
+                    if (net.started) {
+                        AddLocalInput(net.session, input);
+                        if (input) NoteInputApplied(latency);
+                        if (AdvanceRollback(net.session)) {
+                            previous = world;
+                            world = net.session.world;
+                            PlayEvents(world.events);
+                            if (IsMatchOver(world)) state = OVER;
+                        }
+                    }
+                    SendNetplay(net);
+                }
+
+                BeginFrame();
                 ClearBackground(BG_COLOR);
-                DrawGameUI(playerScore, botScore);
-                DrawRoundedPaddle(player, PADDLE_COLOR);
-                DrawRoundedPaddle(bot, PADDLE_COLOR);
-                DrawGlowBall(circle.center, BALL_RADIUS, BALL_COLOR);
-                DrawParticles();
-                EndDrawing();
+                DrawMatch(previous, world, (float)(accumulator / step));
+                DrawParticles(particles);
+                if (!net.started) {
+                    const char* waiting = net.hosting ? TextFormat("Waiting for an opponent on port %d", options.hostPort)
+                                                      : TextFormat("Connecting to %s", options.joinAddress);
+                    DrawText(waiting, SCREEN_WIDTH / 2 - MeasureText(waiting, 30) / 2, SCREEN_HEIGHT / 2 + 60, 30, UI_COLOR);
+                    if (net.otherPhysics) {
+                        const char* refused = "Ignoring a peer built with the other physics mode";
+                        DrawText(refused, SCREEN_WIDTH / 2 - MeasureText(refused, 20) / 2, SCREEN_HEIGHT / 2 + 100, 20, RED);
+                    }
+                } else {
+                    const RollbackStats& stats = net.session.stats;
+                    DrawText(TextFormat("Rollbacks: %ld (max %d frames) | Waits: %ld", stats.rollbacks, stats.maxDepth, stats.stalls),
+                             10, SCREEN_HEIGHT - 30, 20, ColorAlpha(WHITE, 0.8f));
+                    if (net.session.desyncFrame >= 0) {
+                        DrawText(TextFormat("DESYNC at frame %lld", (long long)net.session.desyncFrame),
+                                 10, SCREEN_HEIGHT - 60, 20, RED);
+                    }
+                }
+                PresentFrame(showProfiler);
                 break;
             }
 
-            case OVER: {
-                if (IsKeyPressed(KEY_ENTER)) {
+            case CHAOS: {
+                uint8_t input = 0;
+                {
+                    PROFILE_ZONE(ZONE_INPUT);
+                    if (IsKeyDown(KEY_UP)) input |= INPUT_UP;
+                    if (IsKeyDown(KEY_DOWN)) input |= INPUT_DOWN;
+                }
+
+                // Endless; ESC to menu
+                if (KeyPressed(KEY_ESCAPE)) {
                     state = MENU;
-                    particles.clear();
+                    ClearParticles(particles);
+                }
+
+                double chaosStart = GetTime();
+                for (int i = 0; i < steps && state == CHAOS; i++) {
+                    chaosPlayer = chaos.player;
+                    chaosBot = chaos.bot;
+                    if (input) NoteInputApplied(latency);
+                    StepChaos(chaos, input);
+                    PlayEvents(chaos.events);
                 }
+                double chaosTime = GetTime() - chaosStart;
 
-                BeginDrawing();
+                float alpha = (float)(accumulator / step);
+                BeginFrame();
                 ClearBackground(BG_COLOR);
-                DrawGameOver(playerScore, botScore);
-                DrawParticles();
-                EndDrawing();
+                DrawGameUI(chaos.playerScore, chaos.botScore);
+                DrawRoundedPaddle(LerpPaddle(chaosPlayer, chaos.player, alpha));
+                DrawRoundedPaddle(LerpPaddle(chaosBot, chaos.bot, alpha));
+                DrawChaosBalls(chaos, alpha);
+                DrawParticles(particles);
+                DrawText(TextFormat("Balls: %d | Contacts: %ld of %ld pairs tested | Update: %.3f ms",
+                                    chaos.count, chaos.stats.contacts, chaos.stats.pairsTested, chaosTime * 1000.0),
+                         10, SCREEN_HEIGHT - 30, 20, ColorAlpha(WHITE, 0.8f));
+                PresentFrame(showProfiler);
+                break;
+            }
+
+            case REPLAY: {
+                // Space pauses, left/right jump 5 seconds
+                if (KeyPressed(KEY_SPACE)) replayPaused = !replayPaused;
+                int jump = 0;
+                if (KeyPressed(KEY_LEFT)) jump = -5 * SIM_HZ;
+                if (KeyPressed(KEY_RIGHT)) jump = 5 * SIM_HZ;
+                if (jump != 0) {
+                    long target = (long)replay.frame + jump;
+                    if (target < 0) target = 0;
+                    if (target > (long)replay.frameCount) target = replay.frameCount;
+                    SeekReplay(replay, (uint32_t)target);
+                    world = previous = replay.world;
+                    ClearParticles(particles);
+                }
+
+                for (int i = 0; i < steps && !replayPaused; i++) {
+                    previous = world;
+                    if (!StepReplay(replay)) break;
+                    world = replay.world;
+                    PlayEvents(world.events);
+                }
+
+                if (KeyPressed(KEY_ESCAPE)) {
+                    CloseReplay(replay);
+                    state = MENU;
+                    ClearParticles(particles);
+                }
+
+                BeginFrame();
+                ClearBackground(BG_COLOR);
+                DrawMatch(previous, world, replayPaused ? 1.0f : (float)(accumulator / step));
+                DrawParticles(particles);
+                DrawText(TextFormat("REPLAY %d / %d%s", replay.frame, replay.frameCount, replayPaused ? " (paused)" : ""),
+                         10, SCREEN_HEIGHT - 30, 20, ColorAlpha(WHITE, 0.8f));
+                if (replay.desyncFrame >= 0) {
+                    DrawText(TextFormat("DESYNC at frame %lld", (long long)replay.desyncFrame),
+                             10, SCREEN_HEIGHT - 60, 20, RED);
+                }
+                PresentFrame(showProfiler);
+                break;
+            }
+        }
+        double frameWork = GetTime() - frameStart;
+
+        if (firstFrame) {
+            firstFrame = false;
+            TraceLog(LOG_INFO, "Time to first frame: %.1f ms", sinceLaunch());
+            InitAudioDevice();
+            StartAudioLatency();
+        }
+        if (!sounds.loaded && FinishLoadingAssets(sounds)) {
+            TraceLog(LOG_INFO, "Sounds ready after %.1f ms", sinceLaunch());
+            InitVoicePool(paddleVoices, sounds.paddleHit, options.voices);
+            InitVoicePool(wallVoices, sounds.wallHit, options.voices);
+            InitVoicePool(scoreVoices, sounds.score, options.voices);
+        }
+
+        FramePresented(pacer);
+        NoteFramePresented(latency);
+        if (options.dynamicResolution) {
+            UpdateResolutionController(resolution, frameWork);
+            renderScale = resolution.scale;
+        }
+        NoteKeyDown(latency);
+        ProfileFrameEnd();
+
+        frameAllocations = ThreadAllocationCount() - frameAllocStart + simFrameAllocations;
+        if (options.allocCheck > 0 && steadyFrame) {
+            if (frameAllocations > 0) {
+                TraceLog(LOG_ERROR, "Alloc check failed: %llu heap allocations in GAME frame %ld", (unsigned long long)frameAllocations,
+                         allocCheckFrames);
+                allocCheckFailed = true;
+                break;
+            }
+            allocCheckFrames++;
+            allocCheckSeconds += GetFrameTime();
+            if (allocCheckSeconds >= options.allocCheck) {
+                TraceLog(LOG_INFO, "Alloc check passed: %ld GAME frames without a heap allocation", allocCheckFrames);
                 break;
             }
         }
     }
 
+    if (latency.count > 0) {
+        TraceLog(LOG_INFO, "Input latency over %d presses: p50 %.1f ms, p99 %.1f ms", latency.count,
+                 LatencyPercentile(latency, 50), LatencyPercentile(latency, 99));
+    }
+    if (AudioLatencyCount() > 0) {
+        TraceLog(LOG_INFO, "Event to audio output over %d sounds: p50 %.1f ms, p99 %.1f ms", AudioLatencyCount(),
+                 AudioLatencyPercentile(50), AudioLatencyPercentile(99));
+    }
+    if (options.dynamicResolution) {
+        TraceLog(LOG_INFO, "Dynamic resolution: %d drops, %d raises, ended at %.0f%%", resolution.drops, resolution.raises,
+                 resolution.scale * 100);
+    }
+    if (searchBot.stats.thinks > 0) {
+        const SearchStats& search = searchBot.stats;
+        TraceLog(LOG_INFO, "Expert bot over %ld frames: mean %.1f us, max %.1f us, %ld over budget, %ld of %ld shots reused",
+                 search.thinks, search.totalMicros / search.thinks, search.maxMicros, search.overruns,
+                 search.reusedShots, search.reusedShots + search.newShots);
+    }
+
     // Cleanup
-    UnloadSound(paddleHit);
-    UnloadSound(wallHit);
-    UnloadSound(scoreSound);
+    StopSimMatch();
+    ShutdownProfiler();
+    SaveRecording(options.recordDir);
+    CloseReplay(replay);
+    CloseNetplay(net);
+    UnloadFrameTarget(frameTarget);
+    UnloadRenderCache();
+    StopAudioLatency();
+    UnloadVoicePool(paddleVoices);
+    UnloadVoicePool(wallVoices);
+    UnloadVoicePool(scoreVoices);
+    UnloadAssets(sounds);
     CloseAudioDevice();
     CloseWindow();
-    return 0;
-}
\ No newline at end of file
+    return allocCheckFailed ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+#include "netplay.h"
+#include "fixed.h"
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+static bool OpenNetplay(Netplay& net, uint16_t port, int subSteps, int inputDelay) {
+    memset(&net, 0, sizeof(net));
+    net.subSteps = subSteps < 1 ? 1 : (subSteps > MAX_PACKET_SUB_STEPS ? MAX_PACKET_SUB_STEPS : subSteps);
+    net.inputDelay = inputDelay;
+    net.active = OpenUdpSocket(net.sock, port);
+    return net.active;
+}
+
+bool HostNetplay(Netplay& net, uint16_t port, int subSteps, int inputDelay) {
+    if (!OpenNetplay(net, port, subSteps, inputDelay)) return false;
+    net.hosting = true;
+    return true;
+}
+
+bool JoinNetplay(Netplay& net, const char* address, int subSteps, int inputDelay) {
+    const char* colon = strrchr(address, ':');
+    if (!colon) return false;
+    char host[256];
+    size_t length = (size_t)(colon - address);
+    if (length >= sizeof(host)) return false;
+    memcpy(host, address, length);
+    host[length] = '\0';
+
+    if (!OpenNetplay(net, 0, subSteps, inputDelay)) return false;
+    if (!ResolveAddress(host, (uint16_t)atoi(colon + 1), net.peer)) {
+        CloseNetplay(net);
+        return false;
+    }
+    return true;
+}
+
+void CloseNetplay(Netplay& net) {
+    if (!net.active) return;
+    CloseUdpSocket(net.sock);
+    net.active = false;
+    net.started = false;
+}
+
+void ReceiveNetplay(Netplay& net) {
+    if (!net.active) return;
+    uint8_t buffer[MAX_PACKET_SIZE];
+    NetAddress from;
+    int size;
+    while ((size = ReceiveDatagram(net.sock, from, buffer, sizeof(buffer))) >= 0) {
+        InputPacket packet;
+        if (!DecodeInputPacket(buffer, size, packet)) continue;
+        if (packet.physicsMode != PHYSICS_MODE) {
+            // Float and fixed-point builds part ways on the first frame
+            net.otherPhysics = true;
+            continue;
+        }
+
+        if (!net.started) {
+            // The first packet settles who the opponent is, the seed and the sub-steps
+            if (net.hosting) {
+                net.peer = from;
+                InitRollback(net.session, LEFT_SIDE, (uint64_t)time(NULL), net.subSteps, net.inputDelay);
+            } else {
+                if (!SameAddress(from, net.peer)) continue;
+                net.subSteps = packet.subSteps;
+                InitRollback(net.session, RIGHT_SIDE, packet.seed, net.subSteps, net.inputDelay);
+            }
+            net.started = true;
+        }
+        if (SameAddress(from, net.peer)) ReceiveInputPacket(net.session, packet);
+    }
+}
+
+void SendNetplay(Netplay& net) {
+    if (!net.active) return;
+    InputPacket packet = {};
+    if (net.started) BuildInputPacket(net.session, packet);
+    else if (net.hosting) return; // Nobody to talk to yet
+    else {
+        packet.subSteps = (uint8_t)net.subSteps;
+        packet.physicsMode = (uint8_t)PHYSICS_MODE;
+    }
+
+    uint8_t buffer[MAX_PACKET_SIZE];
+    int size = EncodeInputPacket(packet, buffer);
+    SendDatagram(net.sock, net.peer, buffer, size);
+}
@@ -0,0 +1,31 @@
+#ifndef PONG_NETPLAY_H
+#define PONG_NETPLAY_H
+
+#include "rollback.h"
+#include "udp.h"
+
+// Two-player match over UDP. The host waits on a port and plays the left
+// paddle; the joining side sends hellos until the host answers with the
+// match seed and sub-steps, then plays the right paddle. Builds on
+// different physics modes ignore each other.
+struct Netplay {
+    bool active;
+    bool hosting;
+    bool started;   // Both sides known, session running
+    UdpSocket sock;
+    NetAddress peer;
+    int subSteps;   // The host's, once started
+    int inputDelay;
+    bool otherPhysics; // Heard from a peer on the other physics mode
+    RollbackSession session;
+};
+
+bool HostNetplay(Netplay& net, uint16_t port, int subSteps, int inputDelay);
+bool JoinNetplay(Netplay& net, const char* address, int subSteps, int inputDelay); // "host:port"
+void CloseNetplay(Netplay& net);
+
+// Once per simulation step: take in everything that arrived, then send ours
+void ReceiveNetplay(Netplay& net);
+void SendNetplay(Netplay& net);
+
+#endif //PONG_NETPLAY_H
@@ -0,0 +1,193 @@
+// pong_netsim - two rollback peers talking over loopback UDP through a
+// simulated bad link, with scripted players on both paddles
+//
+//   pong_netsim [--frames N] [--latency MS] [--jitter MS] [--loss PERCENT]
+//               [--delay FRAMES] [--seed S] [--port P]
+//
+// Time is simulated (one tick per 1/120 s), so a run takes as long as the
+// simulation does. Reports rollback depth and re-simulation cost, and
+// checks both sides ended up with identical confirmed states.
+
+#include "core.h"
+#include "rollback.h"
+#include "udp.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+
+const int TICKS_PER_SECOND = 120;
+
+struct Peer {
+    const char* name;
+    RollbackSession session;
+    UdpSocket sock;
+    NetAddress remote;
+    Rng script;
+    uint8_t held;
+    int holdFrames;
+    double maxAdvanceMicros;
+    std::map<uint32_t, uint64_t> checksums;
+};
+
+struct InFlight {
+    double deliverAt;
+    int from;
+    int size;
+    uint8_t data[MAX_PACKET_SIZE];
+};
+
+// Chases the ball with some reaction time, so inputs change every few frames
+static uint8_t ScriptedInput(Peer& peer) {
+    if (peer.holdFrames-- > 0) return peer.held;
+    const World& world = peer.session.world;
+    const Rectangle& paddle = peer.session.localSide == LEFT_SIDE ? world.player : world.bot;
+    float center = paddle.y + PADDLE_HEIGHT / 2.0f;
+    float target = world.circle.center.y + RandomValue(peer.script, -60, 60);
+    peer.held = 0;
+    if (target < center - 20) peer.held = INPUT_UP;
+    if (target > center + 20) peer.held = INPUT_DOWN;
+    peer.holdFrames = RandomValue(peer.script, 2, 20);
+    return peer.held;
+}
+
+int main(int argc, char** argv) {
+    int frames = 10000;
+    double latency = 50.0;
+    double jitter = 10.0;
+    double loss = 5.0;
+    int delay = 2;
+    uint64_t seed = 1;
+    int port = 47000;
+
+    for (int i = 1; i < argc; i++) {
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--frames") == 0 && next) frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--latency") == 0 && next) latency = atof(argv[++i]);
+        else if (strcmp(argv[i], "--jitter") == 0 && next) jitter = atof(argv[++i]);
+        else if (strcmp(argv[i], "--loss") == 0 && next) loss = atof(argv[++i]);
+        else if (strcmp(argv[i], "--delay") == 0 && next) delay = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && next) seed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--port") == 0 && next) port = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    static Peer peers[2];
+    peers[0].name = "left";
+    peers[1].name = "right";
+    for (int p = 0; p < 2; p++) {
+        if (!OpenUdpSocket(peers[p].sock, (uint16_t)(port + p))) {
+            fprintf(stderr, "Could not open UDP port %d\n", port + p);
+            return 1;
+        }
+        ResolveAddress("127.0.0.1", (uint16_t)(port + 1 - p), peers[p].remote);
+        InitRollback(peers[p].session, p == 0 ? LEFT_SIDE : RIGHT_SIDE, seed, 1, delay);
+        SeedRng(peers[p].script, seed * 31 + p);
+    }
+
+    Rng link;
+    SeedRng(link, seed ^ 0xABCDEF);
+    std::vector<InFlight> inFlight;
+    long sent = 0;
+    long dropped = 0;
+
+    long maxTicks = (long)frames * 4 + TICKS_PER_SECOND * 10;
+    long tick = 0;
+    for (; tick < maxTicks; tick++) {
+        if (peers[0].session.frame >= (uint32_t)frames && peers[1].session.frame >= (uint32_t)frames) break;
+        double now = (double)tick / TICKS_PER_SECOND;
+
+        // Deliver whatever the link has held long enough
+        for (size_t i = 0; i < inFlight.size();) {
+            if (inFlight[i].deliverAt <= now) {
+                Peer& from = peers[inFlight[i].from];
+                SendDatagram(from.sock, from.remote, inFlight[i].data, inFlight[i].size);
+                inFlight[i] = inFlight.back();
+                inFlight.pop_back();
+            } else {
+                i++;
+            }
+        }
+
+        for (Peer& peer : peers) {
+            uint8_t buffer[MAX_PACKET_SIZE];
+            NetAddress from;
+            int size;
+            while ((size = ReceiveDatagram(peer.sock, from, buffer, sizeof(buffer))) >= 0) {
+                InputPacket packet;
+                if (DecodeInputPacket(buffer, size, packet)) ReceiveInputPacket(peer.session, packet);
+            }
+        }
+
+        for (int p = 0; p < 2; p++) {
+            Peer& peer = peers[p];
+            auto start = std::chrono::steady_clock::now();
+            AddLocalInput(peer.session, ScriptedInput(peer));
+            AdvanceRollback(peer.session);
+            double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            if (micros > peer.maxAdvanceMicros) peer.maxAdvanceMicros = micros;
+
+            if (peer.session.lastChecksumFrame) {
+                int slot = (peer.session.lastChecksumFrame / CHECKSUM_INTERVAL) % CHECKSUM_HISTORY;
+                peer.checksums[peer.session.lastChecksumFrame] = peer.session.checksums[slot];
+            }
+
+            InputPacket packet;
+            BuildInputPacket(peer.session, packet);
+            sent++;
+            if (RandomValue(link, 0, 9999) < loss * 100) {
+                dropped++;
+                continue;
+            }
+            InFlight flight;
+            double wobble = jitter * (RandomValue(link, -1000, 1000) / 1000.0);
+            flight.deliverAt = now + (latency + wobble > 0 ? latency + wobble : 0) / 1000.0;
+            flight.from = p;
+            flight.size = EncodeInputPacket(packet, flight.data);
+            inFlight.push_back(flight);
+        }
+    }
+
+    printf("Link: %.0f ms +- %.0f ms one way, %.1f%% loss (%ld of %ld packets), input delay %d, %ld ticks\n",
+           latency, jitter, loss, dropped, sent, delay, tick);
+    printf("Snapshot: %zu bytes per frame, %d frames kept\n\n", sizeof(World), ROLLBACK_FRAMES + 1);
+    printf("%-6s%9s%8s%11s%11s%11s%14s%14s%12s%16s\n", "peer", "frames", "stalls", "rollbacks", "avg depth",
+           "max depth", "resim frames", "us/rollback", "max us", "max advance us");
+    for (Peer& peer : peers) {
+        const RollbackStats& s = peer.session.stats;
+        printf("%-6s%9ld%8ld%11ld%11.2f%11d%14ld%14.2f%12.2f%16.2f\n", peer.name, s.framesSimulated, s.stalls,
+               s.rollbacks, s.rollbacks ? (double)s.framesResimulated / s.rollbacks : 0.0, s.maxDepth,
+               s.framesResimulated, s.rollbacks ? s.resimMicros / s.rollbacks : 0.0, s.maxResimMicros,
+               peer.maxAdvanceMicros);
+    }
+
+    printf("\nRollback depth histogram (left / right)\n");
+    for (int d = 1; d <= ROLLBACK_FRAMES; d++) {
+        long left = peers[0].session.stats.depthHistogram[d];
+        long right = peers[1].session.stats.depthHistogram[d];
+        if (left || right) printf("%4d: %8ld %8ld\n", d, left, right);
+    }
+
+    // Every state both sides confirmed must match
+    long compared = 0;
+    long mismatched = 0;
+    for (const auto& entry : peers[0].checksums) {
+        auto other = peers[1].checksums.find(entry.first);
+        if (other == peers[1].checksums.end()) continue;
+        compared++;
+        if (other->second != entry.second) mismatched++;
+    }
+    printf("\nConfirmed states compared: %ld, mismatched: %ld", compared, mismatched);
+    for (Peer& peer : peers) {
+        if (peer.session.desyncFrame >= 0) printf(", %s saw a desync at frame %lld", peer.name, (long long)peer.session.desyncFrame);
+    }
+    printf("\n");
+
+    for (Peer& peer : peers) CloseUdpSocket(peer.sock);
+    return mismatched == 0 && peers[0].session.desyncFrame < 0 && peers[1].session.desyncFrame < 0 ? 0 : 1;
+}
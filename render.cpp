@@ -0,0 +1,450 @@
+#include "render.h"
+#include "profiler.h"
+#include <rlgl.h>
+#include <cmath>
+
+// Baked layers
+struct RenderCache {
+    RenderTexture2D playfield; // Background, borders, corner accents, center line
+    RenderTexture2D paddle;    // Paddle with its glow
+    RenderTexture2D ball;      // Ball with glow and highlight
+    Texture2D particle;        // White dot, tinted per particle
+    RenderTexture2D chaosBall; // Small ball with a thin glow
+};
+
+static RenderCache cache;
+
+const int PADDLE_GLOW = 8;
+const int BALL_GLOW = 15;
+const int PARTICLE_SIZE = 8;
+const int PARTICLES_PER_CHUNK = 1024;
+const int CHAOS_BALL_GLOW = 4;
+
+static void DrawPlayfield() {
+    ClearBackground(BG_COLOR);
+
+    // Draw decorative borders
+    // Top border
+    DrawRectangleGradientV(0, 0, SCREEN_WIDTH, BORDER_THICKNESS,
+                           ColorAlpha(ACCENT_COLOR, 0.3f), ColorAlpha(ACCENT_COLOR, 0.1f));
+    DrawRectangle(0, BORDER_THICKNESS - 3, SCREEN_WIDTH, 3, ACCENT_COLOR);
+
+    // Bottom border
+    DrawRectangleGradientV(0, PLAY_AREA_BOTTOM, SCREEN_WIDTH, BORDER_THICKNESS,
+                           ColorAlpha(ACCENT_COLOR, 0.1f), ColorAlpha(ACCENT_COLOR, 0.3f));
+    DrawRectangle(0, PLAY_AREA_BOTTOM, SCREEN_WIDTH, 3, ACCENT_COLOR);
+
+    // Decorative corner accents
+    DrawCircle(40, BORDER_THICKNESS / 2, 5, PADDLE_COLOR);
+    DrawCircle(SCREEN_WIDTH - 40, BORDER_THICKNESS / 2, 5, PADDLE_COLOR);
+    DrawCircle(40, PLAY_AREA_BOTTOM + BORDER_THICKNESS / 2, 5, PADDLE_COLOR);
+    DrawCircle(SCREEN_WIDTH - 40, PLAY_AREA_BOTTOM + BORDER_THICKNESS / 2, 5, PADDLE_COLOR);
+
+    // Dashed center line (only in play area)
+    for (int i = PLAY_AREA_TOP; i < PLAY_AREA_BOTTOM; i += 30) {
+        DrawRectangle(SCREEN_WIDTH / 2 - 3, i, 6, 20, ColorAlpha(UI_COLOR, 0.3f));
+    }
+}
+
+// Draw rounded paddle with glow
+static void DrawPaddleShape(Rectangle rec, Color color) {
+    // Glow effect
+    DrawRectangleGradientEx(
+        {rec.x - PADDLE_GLOW, rec.y - PADDLE_GLOW, rec.width + 2 * PADDLE_GLOW, rec.height + 2 * PADDLE_GLOW},
+        ColorAlpha(color, 0), ColorAlpha(color, 0.1f),
+        ColorAlpha(color, 0.1f), ColorAlpha(color, 0)
+    );
+
+    // Main paddle body with rounded corners
+    DrawRectangleRounded(rec, 0.5f, 10, color);
+
+    // Bright center line
+    DrawRectangleRounded({rec.x + rec.width/2 - 2, rec.y + 5, 4, rec.height - 10},
+                         0.5f, 5, ColorAlpha(WHITE, 0.5f));
+}
+
+// Draw ball with glow and trail
+static void DrawBallShape(Vector2 pos, float radius, Color color) {
+    // Outer glow layers
+    for (int i = 3; i > 0; i--) {
+        float glowRadius = radius + (i * 5);
+        float alpha = 0.15f / i;
+        DrawCircleV(pos, glowRadius, ColorAlpha(color, alpha));
+    }
+
+    // Main ball
+    DrawCircleV(pos, radius, color);
+
+    // Highlight
+    DrawCircleV({pos.x - 5, pos.y - 5}, radius / 3, ColorAlpha(WHITE, 0.6f));
+}
+
+// Sprites are stored with straight alpha so they blend like the shapes did.
+// The target starts out as the sprite color at zero alpha and coverage is
+// accumulated separately, which is exact for layers of one color and for
+// the white highlights that sit on the opaque body.
+static void BeginSprite(RenderTexture2D target, Color color) {
+    BeginTextureMode(target);
+    ClearBackground(ColorAlpha(color, 0));
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                              RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+}
+
+static void EndSprite(RenderTexture2D target) {
+    EndBlendMode();
+    EndTextureMode();
+    SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+}
+
+// Render textures come out upside down
+static void DrawTarget(RenderTexture2D target, Vector2 position) {
+    Rectangle source = {0, 0, (float)target.texture.width, -(float)target.texture.height};
+    DrawTextureRec(target.texture, source, position, WHITE);
+}
+
+void LoadRenderCache() {
+    cache.playfield = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
+    BeginTextureMode(cache.playfield);
+    DrawPlayfield();
+    EndTextureMode();
+
+    cache.paddle = LoadRenderTexture(PADDLE_WIDTH + 2 * PADDLE_GLOW, PADDLE_HEIGHT + 2 * PADDLE_GLOW);
+    BeginSprite(cache.paddle, PADDLE_COLOR);
+    DrawPaddleShape({PADDLE_GLOW, PADDLE_GLOW, PADDLE_WIDTH, PADDLE_HEIGHT}, PADDLE_COLOR);
+    EndSprite(cache.paddle);
+
+    int ballSize = 2 * (BALL_RADIUS + BALL_GLOW);
+    cache.ball = LoadRenderTexture(ballSize, ballSize);
+    BeginSprite(cache.ball, BALL_COLOR);
+    DrawBallShape({ballSize / 2.0f, ballSize / 2.0f}, BALL_RADIUS, BALL_COLOR);
+    EndSprite(cache.ball);
+
+    int chaosSize = 2 * (CHAOS_BALL_RADIUS + CHAOS_BALL_GLOW);
+    cache.chaosBall = LoadRenderTexture(chaosSize, chaosSize);
+    BeginSprite(cache.chaosBall, BALL_COLOR);
+    DrawCircleV({chaosSize / 2.0f, chaosSize / 2.0f}, CHAOS_BALL_RADIUS + CHAOS_BALL_GLOW, ColorAlpha(BALL_COLOR, 0.2f));
+    DrawCircleV({chaosSize / 2.0f, chaosSize / 2.0f}, CHAOS_BALL_RADIUS, BALL_COLOR);
+    EndSprite(cache.chaosBall);
+
+    Image dot = GenImageColor(PARTICLE_SIZE, PARTICLE_SIZE, Color{255, 255, 255, 0});
+    ImageDrawCircle(&dot, PARTICLE_SIZE / 2, PARTICLE_SIZE / 2, 3, WHITE);
+    cache.particle = LoadTextureFromImage(dot);
+    UnloadImage(dot);
+}
+
+void UnloadRenderCache() {
+    UnloadRenderTexture(cache.playfield);
+    UnloadRenderTexture(cache.paddle);
+    UnloadRenderTexture(cache.ball);
+    UnloadTexture(cache.particle);
+    UnloadRenderTexture(cache.chaosBall);
+}
+
+void BeginFrameTarget(FrameTarget& target, float renderScale) {
+    float screenWidth = (float)GetScreenWidth();
+    float screenHeight = (float)GetScreenHeight();
+    float fit = fminf(screenWidth / SCREEN_WIDTH, screenHeight / SCREEN_HEIGHT);
+    target.letterbox = {(screenWidth - SCREEN_WIDTH * fit) / 2, (screenHeight - SCREEN_HEIGHT * fit) / 2,
+                        SCREEN_WIDTH * fit, SCREEN_HEIGHT * fit};
+
+    // Full scale is one texel per window pixel, high DPI included
+    float density = GetRenderWidth() / screenWidth;
+    int fullWidth = (int)(target.letterbox.width * density + 0.5f);
+    int fullHeight = (int)(target.letterbox.height * density + 0.5f);
+    if (target.texture.id == 0 || target.texture.texture.width != fullWidth || target.texture.texture.height != fullHeight) {
+        if (target.texture.id != 0) UnloadRenderTexture(target.texture);
+        target.texture = LoadRenderTexture(fullWidth, fullHeight);
+        SetTextureFilter(target.texture.texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    Camera2D camera = {};
+    camera.zoom = fullWidth * renderScale / SCREEN_WIDTH;
+    target.width = (int)(SCREEN_WIDTH * camera.zoom + 0.5f);
+    target.height = (int)(SCREEN_HEIGHT * camera.zoom + 0.5f);
+
+    SetMouseOffset((int)-target.letterbox.x, (int)-target.letterbox.y);
+    SetMouseScale(SCREEN_WIDTH / target.letterbox.width, SCREEN_HEIGHT / target.letterbox.height);
+
+    BeginTextureMode(target.texture);
+    BeginMode2D(camera);
+}
+
+void EndFrameTarget(FrameTarget& target) {
+    EndMode2D();
+    EndTextureMode();
+
+    // The drawn part is the top left of the picture, which render textures
+    // store upside down at the end of the texture
+    BeginDrawing();
+    ClearBackground(BLACK);
+    Rectangle source = {0, (float)(target.texture.texture.height - target.height), (float)target.width, -(float)target.height};
+    DrawTexturePro(target.texture.texture, source, target.letterbox, {0, 0}, 0.0f, WHITE);
+}
+
+void UnloadFrameTarget(FrameTarget& target) {
+    if (target.texture.id != 0) UnloadRenderTexture(target.texture);
+    target.texture = {};
+}
+
+const float RENDER_SCALE_STEP = 0.1f;
+const double OVER_BUDGET = 0.9;  // Drop the scale above this share of the budget
+const double UNDER_BUDGET = 0.6; // Raise it below this one
+const int DROP_SETTLE = 15;      // Frames for the average to see a change
+const int RAISE_SETTLE = 120;    // Go back up slowly, bursts come and go
+
+void InitResolutionController(ResolutionController& controller, double budget, float maxScale) {
+    controller.maxScale = fmaxf(MIN_RENDER_SCALE, fminf(maxScale, 1.0f));
+    controller.scale = controller.maxScale;
+    controller.budget = budget;
+    controller.average = 0.0;
+    controller.settle = 0;
+    controller.drops = 0;
+    controller.raises = 0;
+}
+
+void UpdateResolutionController(ResolutionController& controller, double frameWork) {
+    controller.average += (frameWork - controller.average) * 0.2;
+    if (controller.settle > 0) {
+        controller.settle--;
+        return;
+    }
+    if (controller.average > controller.budget * OVER_BUDGET && controller.scale > MIN_RENDER_SCALE) {
+        controller.scale = fmaxf(MIN_RENDER_SCALE, controller.scale - RENDER_SCALE_STEP);
+        controller.settle = DROP_SETTLE;
+        controller.drops++;
+    } else if (controller.average < controller.budget * UNDER_BUDGET && controller.scale < controller.maxScale) {
+        controller.scale = fminf(controller.maxScale, controller.scale + RENDER_SCALE_STEP / 2);
+        controller.settle = RAISE_SETTLE;
+        controller.raises++;
+    }
+}
+
+void DrawGameUI(int playerScore, int botScore) {
+    PROFILE_ZONE(ZONE_DRAW_FIELD);
+    DrawTarget(cache.playfield, {0, 0});
+
+    // Scores with glow
+    DrawText(TextFormat("%d", playerScore), SCREEN_WIDTH / 2 - 100, BORDER_THICKNESS + 10, 60, ColorAlpha(PADDLE_COLOR, 0.8f));
+    DrawText(TextFormat("%d", botScore), SCREEN_WIDTH / 2 + 60, BORDER_THICKNESS + 10, 60, ColorAlpha(PADDLE_COLOR, 0.8f));
+
+    // FPS
+    DrawText(TextFormat("FPS: %d", GetFPS()), 10, 10, 20, ColorAlpha(WHITE, 0.5f));
+
+    // Instructions
+    DrawText("F11 - Fullscreen | ESC - Menu", SCREEN_WIDTH - 350, 10, 20, ColorAlpha(WHITE, 0.5f));
+}
+
+void DrawRoundedPaddle(Rectangle rec) {
+    PROFILE_ZONE(ZONE_DRAW_SPRITES);
+    DrawTarget(cache.paddle, {rec.x - PADDLE_GLOW, rec.y - PADDLE_GLOW});
+}
+
+void DrawGlowBall(Vector2 pos) {
+    PROFILE_ZONE(ZONE_DRAW_SPRITES);
+    float half = cache.ball.texture.width / 2.0f;
+    DrawTarget(cache.ball, {pos.x - half, pos.y - half});
+}
+
+// One textured quad per particle, all in the same batch
+void DrawParticles(const ParticlePool& particles) {
+    PROFILE_ZONE(ZONE_DRAW_PARTICLES);
+    const float half = PARTICLE_SIZE / 2.0f;
+
+    for (int start = 0; start < particles.count; start += PARTICLES_PER_CHUNK) {
+        int end = start + PARTICLES_PER_CHUNK;
+        if (end > particles.count) end = particles.count;
+
+        // May flush a full batch, which also resets the bound texture
+        rlCheckRenderBatchLimit(4 * (end - start));
+        rlSetTexture(cache.particle.id);
+        rlBegin(RL_QUADS);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        for (int i = start; i < end; i++) {
+            float x = particles.positionX[i];
+            float y = particles.positionY[i];
+            float alpha = particles.lifetime[i];
+            if (alpha > 1.0f) alpha = 1.0f;
+            Color color = particles.color[i];
+            rlColor4ub(color.r, color.g, color.b, (unsigned char)(alpha * 255.0f));
+
+            rlTexCoord2f(0.0f, 0.0f);
+            rlVertex2f(x - half, y - half);
+            rlTexCoord2f(0.0f, 1.0f);
+            rlVertex2f(x - half, y + half);
+            rlTexCoord2f(1.0f, 1.0f);
+            rlVertex2f(x + half, y + half);
+            rlTexCoord2f(1.0f, 0.0f);
+            rlVertex2f(x + half, y - half);
+        }
+        rlEnd();
+    }
+    rlSetTexture(0);
+}
+
+// Same batching as the particles. Positions are drawn back along the
+// velocity rather than lerped, so no copy of the previous step is needed.
+void DrawChaosBalls(const ChaosWorld& chaos, float alpha) {
+    PROFILE_ZONE(ZONE_DRAW_SPRITES);
+    const float half = cache.chaosBall.texture.width / 2.0f;
+    const float back = 1.0f - alpha;
+
+    for (int start = 0; start < chaos.count; start += PARTICLES_PER_CHUNK) {
+        int end = start + PARTICLES_PER_CHUNK;
+        if (end > chaos.count) end = chaos.count;
+
+        rlCheckRenderBatchLimit(4 * (end - start));
+        rlSetTexture(cache.chaosBall.texture.id);
+        rlBegin(RL_QUADS);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        rlColor4ub(255, 255, 255, 255);
+        for (int i = start; i < end; i++) {
+            float x = chaos.balls[i].center.x - chaos.velocity[i].x * back;
+            float y = chaos.balls[i].center.y - chaos.velocity[i].y * back;
+
+            // Render textures are upside down
+            rlTexCoord2f(0.0f, 1.0f);
+            rlVertex2f(x - half, y - half);
+            rlTexCoord2f(0.0f, 0.0f);
+            rlVertex2f(x - half, y + half);
+            rlTexCoord2f(1.0f, 0.0f);
+            rlVertex2f(x + half, y + half);
+            rlTexCoord2f(1.0f, 1.0f);
+            rlVertex2f(x + half, y - half);
+        }
+        rlEnd();
+    }
+    rlSetTexture(0);
+}
+
+// Render interpolation between the last two simulation steps
+static Vector2 LerpVector(Vector2 a, Vector2 b, float t) {
+    return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t};
+}
+
+Rectangle LerpPaddle(Rectangle a, Rectangle b, float t) {
+    Rectangle rec = b;
+    rec.y = a.y + (b.y - a.y) * t;
+    return rec;
+}
+
+static bool HasEvent(const EventList& events, EventType type) {
+    for (int i = 0; i < events.count; i++) {
+        if (events.items[i].type == type) return true;
+    }
+    return false;
+}
+
+void DrawMatch(const World& previous, const World& world, float alpha) {
+    // A serve teleports the ball, don't smear it across the field
+    Vector2 ball = world.circle.center;
+    if (!HasEvent(world.events, SCORE)) ball = LerpVector(previous.circle.center, world.circle.center, alpha);
+
+    DrawGameUI(world.playerScore, world.botScore);
+    DrawRoundedPaddle(LerpPaddle(previous.player, world.player, alpha));
+    DrawRoundedPaddle(LerpPaddle(previous.bot, world.bot, alpha));
+    DrawGlowBall(ball);
+}
+
+void SpawnEventParticles(ParticlePool& particles, Rng& rng, const EventList& events) {
+    for (int i = 0; i < events.count; i++) {
+        const GameEvent& e = events.items[i];
+        switch (e.type) {
+            case WALL_HIT:
+                SpawnParticles(particles, rng, e.position, PADDLE_COLOR, 8);
+                break;
+            case PADDLE_HIT:
+                SpawnParticles(particles, rng, e.position, BALL_COLOR, 12);
+                break;
+            case SCORE:
+                if (e.side == RIGHT_SIDE) SpawnParticles(particles, rng, {50, SCREEN_HEIGHT / 2.0f}, BALL_COLOR, 30);
+                else SpawnParticles(particles, rng, {SCREEN_WIDTH - 50, SCREEN_HEIGHT / 2.0f}, PADDLE_COLOR, 30);
+                break;
+        }
+    }
+}
+
+// UI Functions
+void DrawButton(Button button) {
+    PROFILE_ZONE(ZONE_DRAW_OVERLAY);
+    Color color = button.isHovered ? button.hoverColor : button.normalColor;
+
+    // Glow on hover
+    if (button.isHovered) {
+        DrawRectangleRounded({button.rect.x - 5, button.rect.y - 5, button.rect.width + 10, button.rect.height + 10},
+                             0.3f, 10, ColorAlpha(button.hoverColor, 0.3f));
+    }
+
+    // Button
+    DrawRectangleRounded(button.rect, 0.3f, 10, color);
+    DrawRectangleRoundedLines(button.rect, 0.3f, 10, ColorAlpha(WHITE, 0.8f));
+
+    int textWidth = MeasureText(button.text, 30);
+    DrawText(button.text,
+             button.rect.x + (button.rect.width - textWidth) / 2,
+             button.rect.y + 18,
+             30, WHITE);
+}
+
+void DrawMenu() {
+    PROFILE_ZONE(ZONE_DRAW_OVERLAY);
+    DrawText("P O N G", SCREEN_WIDTH / 2 - 200, 150, 100, ACCENT_COLOR);
+    DrawText("Choose Your Difficulty", SCREEN_WIDTH / 2 - 200, 280, 30, UI_COLOR);
+}
+
+void DrawGameOver(int playerScore, int botScore) {
+    PROFILE_ZONE(ZONE_DRAW_OVERLAY);
+    // Overlay
+    DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, ColorAlpha(BLACK, 0.7f));
+
+    if (playerScore >= WIN_SCORE) {
+        DrawText("YOU WIN!", SCREEN_WIDTH / 2 - 250, 250, 100, PADDLE_COLOR);
+    } else {
+        DrawText("YOU LOSE!", SCREEN_WIDTH / 2 - 280, 250, 100, BALL_COLOR);
+    }
+
+    DrawText(TextFormat("Final Score: %d - %d", playerScore, botScore),
+             SCREEN_WIDTH / 2 - 220, 400, 40, WHITE);
+    DrawText("Press ENTER to return to menu", SCREEN_WIDTH / 2 - 280, 550, 30, UI_COLOR);
+    DrawText("Press ESC to quit", SCREEN_WIDTH / 2 - 150, 600, 25, ColorAlpha(WHITE, 0.7f));
+}
+
+// Per-zone frame times for the last PROFILE_HISTORY frames. Draw zones time
+// the CPU side only; waiting on the GPU and vsync shows up in "present".
+void DrawProfilerOverlay() {
+    PROFILE_ZONE(ZONE_DRAW_OVERLAY);
+    const int x = SCREEN_WIDTH - 640;
+    const int top = BORDER_THICKNESS + 10;
+    const int rowHeight = 36;
+    const int graphHeight = 28;
+    const int graphX = x + 380;
+
+    DrawRectangle(x - 10, top, 650, 40 + ZONE_COUNT * rowHeight + 30, ColorAlpha(BLACK, 0.75f));
+    DrawText("PROFILER (F3)      p50     p99     max ms", x, top + 10, 20, UI_COLOR);
+
+    float samples[PROFILE_HISTORY];
+    for (int zone = 0; zone < ZONE_COUNT; zone++) {
+        int y = top + 40 + zone * rowHeight;
+        int n = ProfileHistory((ProfileZone)zone, samples);
+        float worst = 0.0f;
+        for (int i = 0; i < n; i++) worst = fmaxf(worst, samples[i]);
+
+        DrawText(PROFILE_ZONE_NAMES[zone], x, y + 6, 20, WHITE);
+        DrawText(TextFormat("%6.2f  %6.2f  %6.2f", ProfilePercentile((ProfileZone)zone, 50),
+                            ProfilePercentile((ProfileZone)zone, 99), worst), x + 170, y + 6, 20, WHITE);
+
+        // One column per frame, scaled to the zone's worst frame (at least 1 ms)
+        float scale = graphHeight / fmaxf(worst, 1.0f);
+        DrawRectangle(graphX, y, PROFILE_HISTORY, graphHeight, ColorAlpha(UI_COLOR, 0.15f));
+        for (int i = 0; i < n; i++) {
+            int height = (int)(samples[i] * scale + 0.5f);
+            if (height > 0) DrawRectangle(graphX + i, y + graphHeight - height, 1, height, zone == ZONE_FRAME ? ACCENT_COLOR : PADDLE_COLOR);
+        }
+    }
+
+    uint64_t dropped = ProfileDroppedSamples();
+    if (dropped > 0) {
+        DrawText(TextFormat("%llu export samples dropped", (unsigned long long)dropped),
+                 x, top + 40 + ZONE_COUNT * rowHeight, 20, RED);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef PONG_RENDER_H
+#define PONG_RENDER_H
+
+#include <raylib.h>
+#include "chaos.h"
+#include "core.h"
+#include "particles.h"
+
+// Color scheme - Cyberpunk vibes!
+const Color BG_COLOR = Color{10, 10, 30, 255};
+const Color PADDLE_COLOR = Color{0, 255, 200, 255};
+const Color BALL_COLOR = Color{255, 50, 150, 255};
+const Color UI_COLOR = Color{100, 200, 255, 150};
+const Color ACCENT_COLOR = Color{255, 100, 255, 255};
+
+struct Button {
+    Rectangle rect;
+    const char* text;
+    Color normalColor;
+    Color hoverColor;
+    bool isHovered;
+};
+
+// Frames are drawn in SCREEN_WIDTH x SCREEN_HEIGHT logical coordinates into
+// an offscreen texture, then scaled into the window with black bars to keep
+// the aspect ratio. The texture is sized for the letterboxed area at the
+// window's pixel density; a render scale below 1 draws into only part of
+// it, so changing the scale never reallocates. The mouse is mapped back to
+// logical coordinates.
+struct FrameTarget {
+    RenderTexture2D texture;
+    Rectangle letterbox; // Window coordinates
+    int width;           // Pixels drawn this frame
+    int height;
+};
+
+void BeginFrameTarget(FrameTarget& target, float renderScale); // Instead of BeginDrawing
+void EndFrameTarget(FrameTarget& target);                      // Then EndDrawing as usual
+void UnloadFrameTarget(FrameTarget& target);
+
+// Dynamic resolution: lowers the render scale while frames take longer than
+// the budget and raises it again once they have room to spare. Frame work is
+// measured up to the return of EndDrawing; once the GPU falls behind, the
+// buffer swap waits for it, so GPU time is included.
+const float MIN_RENDER_SCALE = 0.5f;
+
+struct ResolutionController {
+    float scale;
+    float maxScale;
+    double budget;  // Seconds of work per frame
+    double average; // Smoothed frame work
+    int settle;     // Frames to wait before the next change
+    int drops;
+    int raises;
+};
+
+void InitResolutionController(ResolutionController& controller, double budget, float maxScale);
+void UpdateResolutionController(ResolutionController& controller, double frameWork); // Once per frame
+
+// Everything on the game screen that never changes is drawn once into
+// textures; a frame is then a handful of blits plus one particle batch.
+// Needs a window, so load it after InitWindow.
+void LoadRenderCache();
+void UnloadRenderCache();
+
+// Game screen
+void DrawGameUI(int playerScore, int botScore);
+void DrawRoundedPaddle(Rectangle rec);
+void DrawGlowBall(Vector2 pos);
+void DrawParticles(const ParticlePool& particles);
+void DrawChaosBalls(const ChaosWorld& chaos, float alpha); // alpha: how far into the next step
+
+// A match, blended between the last two simulation steps
+Rectangle LerpPaddle(Rectangle a, Rectangle b, float t);
+void DrawMatch(const World& previous, const World& world, float alpha);
+void SpawnEventParticles(ParticlePool& particles, Rng& rng, const EventList& events); // Bursts for hits and points
+
+// Menu and game over screens
+void DrawButton(Button button);
+void DrawMenu();
+void DrawGameOver(int playerScore, int botScore);
+
+// Debug
+void DrawProfilerOverlay();
+
+#endif //PONG_RENDER_H
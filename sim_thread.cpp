@@ -0,0 +1,114 @@
+#include "sim_thread.h"
+#include "alloc.h"
+#include "render.h"
+#include <chrono>
+
+const double MAX_CATCH_UP = 0.25; // Seconds behind before giving up on them, like the game's clock
+
+double SimClock() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void InitSimThread(SimThread& sim, int maxParticles, uint64_t seed) {
+    for (SimSnapshot& slot : sim.slots) InitParticlePool(slot.particles, maxParticles);
+    InitParticlePool(sim.particles, maxParticles);
+    SeedRng(sim.particleRng, seed);
+    InitTripleBuffer(sim.buffer);
+    sim.input.store(0);
+    sim.running.store(false);
+}
+
+// One fixed step, then the snapshot out
+static void SimStep(SimThread& sim, SimSnapshot& snapshot, const SimSnapshot& last) {
+    World previous = sim.world;
+    uint8_t input = sim.input.load(std::memory_order_relaxed);
+    uint8_t stepInput = input;
+    if (sim.world.difficulty == EXPERT) stepInput |= ThinkSearchBot(*sim.searchBot, sim.world, sim.searchBudget);
+    if (sim.recorder) RecordReplayFrame(*sim.recorder, sim.world, stepInput);
+    StepWorld(sim.world, stepInput);
+    UpdateParticles(sim.particles, (float)sim.step);
+    SpawnEventParticles(sim.particles, sim.particleRng, sim.world.events);
+
+    snapshot.previous = previous;
+    snapshot.world = sim.world;
+    snapshot.stepTime = SimClock();
+    CopyParticles(snapshot.particles, sim.particles);
+    snapshot.search = sim.searchBot->stats;
+    snapshot.steps = last.steps + 1;
+    snapshot.allocations = ThreadAllocationCount();
+    snapshot.wallHits = last.wallHits;
+    snapshot.paddleHits = last.paddleHits;
+    snapshot.scores = last.scores;
+    for (int i = 0; i < sim.world.events.count; i++) {
+        switch (sim.world.events.items[i].type) {
+            case WALL_HIT: snapshot.wallHits++; break;
+            case PADDLE_HIT: snapshot.paddleHits++; break;
+            case SCORE: snapshot.scores++; break;
+        }
+    }
+    snapshot.input = input;
+    snapshot.over = IsMatchOver(sim.world);
+}
+
+static void SimLoop(SimThread* sim) {
+    // Counts carry on from the last snapshot published. The reader may hold
+    // it by now, but both sides only read it; the slot written next is
+    // always another one.
+    SimSnapshot* last = &sim->slots[WriteSlot(sim->buffer)];
+    double next = SimClock();
+    bool over = false;
+    while (!over && sim->running.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(next))));
+        if (SimClock() - next > MAX_CATCH_UP) next = SimClock();
+
+        SimSnapshot& snapshot = sim->slots[WriteSlot(sim->buffer)];
+        SimStep(*sim, snapshot, *last);
+        over = snapshot.over;
+        PublishSlot(sim->buffer);
+        last = &snapshot;
+        next += sim->step;
+    }
+}
+
+void StartSimThread(SimThread& sim, const World& world, SearchBot& searchBot, int searchBudget, ReplayWriter* recorder) {
+    sim.world = world;
+    ClearParticles(sim.particles);
+    sim.searchBot = &searchBot;
+    sim.recorder = recorder;
+    sim.searchBudget = searchBudget;
+    sim.step = 1.0 / SIM_HZ;
+
+    // Every slot starts as the match before its first step
+    InitTripleBuffer(sim.buffer);
+    for (SimSnapshot& slot : sim.slots) {
+        slot.previous = world;
+        slot.world = world;
+        slot.stepTime = SimClock();
+        ClearParticles(slot.particles);
+        slot.search = searchBot.stats;
+        slot.steps = 0;
+        slot.allocations = 0;
+        slot.wallHits = 0;
+        slot.paddleHits = 0;
+        slot.scores = 0;
+        slot.input = 0;
+        slot.over = false;
+    }
+    sim.input.store(0);
+    sim.running.store(true, std::memory_order_release);
+    sim.thread = std::thread(SimLoop, &sim);
+}
+
+void SetSimInput(SimThread& sim, uint8_t input) {
+    sim.input.store(input, std::memory_order_relaxed);
+}
+
+const SimSnapshot& LatestSimSnapshot(SimThread& sim) {
+    return sim.slots[ReadSlot(sim.buffer)];
+}
+
+void StopSimThread(SimThread& sim) {
+    sim.running.store(false, std::memory_order_release);
+    if (sim.thread.joinable()) sim.thread.join();
+}
@@ -0,0 +1,66 @@
+#ifndef PONG_SIM_THREAD_H
+#define PONG_SIM_THREAD_H
+
+#include <raylib.h>
+#include "core.h"
+#include "particles.h"
+#include "replay.h"
+#include "search_bot.h"
+#include "triple_buffer.h"
+#include <atomic>
+#include <thread>
+
+// Single-player matches on a thread of their own: the simulation steps at
+// its fixed rate on its own clock, so a slow present, a vsync wait or a GPU
+// driver stall on the render thread never holds up a step. After every
+// step it publishes a snapshot through a triple buffer; the render thread
+// draws the newest one and never waits. Input goes the other way as one
+// atomic byte.
+//
+// Sounds stay on the render thread: snapshots carry running event counts,
+// so events in snapshots the render thread never saw still play.
+
+struct SimSnapshot {
+    World previous;         // Step before, for blending
+    World world;
+    double stepTime;        // SimClock() when 'world' was stepped
+    ParticlePool particles; // Sized once, at InitSimThread
+    SearchStats search;
+    uint64_t steps;         // Since the match started
+    uint64_t allocations;   // Heap allocations on the sim thread so far
+    long wallHits;          // Since the match started
+    long paddleHits;
+    long scores;
+    uint8_t input;          // Player input 'world' was stepped with
+    bool over;              // Match over, the thread has stopped stepping
+};
+
+struct SimThread {
+    SimSnapshot slots[3];
+    TripleBuffer buffer;
+    std::atomic<uint8_t> input;
+    std::atomic<bool> running;
+    std::thread thread;
+
+    // The sim thread's own, while it runs
+    World world;
+    ParticlePool particles;
+    Rng particleRng;
+    SearchBot* searchBot;
+    ReplayWriter* recorder; // Null when not recording
+    int searchBudget;       // Microseconds per step
+    double step;            // Seconds
+};
+
+double SimClock(); // Seconds, the clock both threads time steps with
+
+// Once at startup; pools are sized here so starting a match doesn't allocate them
+void InitSimThread(SimThread& sim, int maxParticles, uint64_t seed);
+// world: the match as ResetWorld left it. searchBot and recorder are the
+// sim thread's until StopSimThread.
+void StartSimThread(SimThread& sim, const World& world, SearchBot& searchBot, int searchBudget, ReplayWriter* recorder);
+void SetSimInput(SimThread& sim, uint8_t input);
+const SimSnapshot& LatestSimSnapshot(SimThread& sim); // Render thread, never blocks
+void StopSimThread(SimThread& sim);                   // Waits for the step in progress
+
+#endif //PONG_SIM_THREAD_H
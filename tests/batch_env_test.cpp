@@ -0,0 +1,71 @@
+// StepBatchEnv against a World per game stepped with StepWorld, for every
+// difficulty, with random actions. Open-play frames take the four-wide
+// path, the rest go through StepWorld inside the batch; either way every
+// game has to stay identical to its World, rewards and dones included.
+
+#include "batch_env.h"
+#include <cstdio>
+#include <vector>
+
+static bool SameGame(const World& batch, const World& world) {
+    return batch.circle.center == world.circle.center && batch.OldPosition == world.OldPosition &&
+           batch.player.y == world.player.y && batch.bot.y == world.bot.y &&
+           batch.futureCollision.center == world.futureCollision.center &&
+           batch.futureCollision.Collision == world.futureCollision.Collision &&
+           batch.currentSpeed == world.currentSpeed && batch.playerScore == world.playerScore &&
+           batch.botScore == world.botScore && batch.rng.state == world.rng.state;
+}
+
+int main() {
+    const int GAMES = 1003; // Not a whole number of SIMD lanes
+    const int FRAMES = 4000;
+    int failures = 0;
+
+    for (Difficulty difficulty : {EASY, MEDIUM, HARD, EXPERT}) {
+        BatchEnv env;
+        InitBatchEnv(env, GAMES, difficulty, 42);
+        if (difficulty == EXPERT && env.difficulty != HARD) {
+            printf("EXPERT batch env plays as %d, not HARD\n", env.difficulty);
+            failures++;
+        }
+
+        std::vector<World> worlds(GAMES);
+        for (int i = 0; i < GAMES; i++) LoadBatchGame(env, i, worlds[i]);
+        std::vector<uint8_t> actions(GAMES);
+        Rng rng;
+        SeedRng(rng, 7);
+        long dones = 0;
+
+        for (int frame = 0; frame < FRAMES; frame++) {
+            for (int i = 0; i < GAMES; i++) actions[i] = (uint8_t)RandomValue(rng, 0, 3);
+            StepBatchEnv(env, actions.data());
+
+            for (int i = 0; i < GAMES; i++) {
+                World& world = worlds[i];
+                StepWorld(world, actions[i]);
+                float reward = 0.0f;
+                for (int e = 0; e < world.events.count; e++) {
+                    if (world.events.items[e].type == SCORE) reward += world.events.items[e].side == LEFT_SIDE ? 1.0f : -1.0f;
+                }
+                bool done = IsMatchOver(world);
+                if (done) ResetWorld(world, env.difficulty, world.rng.state); // As ResetBatchGame
+
+                World batch;
+                LoadBatchGame(env, i, batch);
+                if (!SameGame(batch, world) || env.rewards[i] != reward || env.dones[i] != done) {
+                    if (failures++ < 10) {
+                        printf("difficulty %d game %d frame %d: ball (%.9g, %.9g), StepWorld (%.9g, %.9g)\n", difficulty, i,
+                               frame, batch.circle.center.x, batch.circle.center.y, world.circle.center.x,
+                               world.circle.center.y);
+                    }
+                    world = batch; // Report each divergence once
+                }
+                dones += done;
+            }
+        }
+        printf("difficulty %d: %d games x %d frames, %ld matches finished\n", difficulty, GAMES, FRAMES, dones);
+    }
+
+    printf("%d mismatches\n", failures);
+    return failures == 0 ? 0 : 1;
+}
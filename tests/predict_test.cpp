@@ -0,0 +1,63 @@
+// PredictCollision and PredictRightIntercept against the frame-by-frame
+// PointOfCollision and RightBorderCollision they stand in for, over random
+// shots. Tolerance: none. Both walk the same float positions, so the
+// border and the position have to come out identical.
+
+#include "fixed.h"
+#include "predict.h"
+#include <cmath>
+#include <cstdio>
+
+static float Uniform(Rng& rng, float low, float high) {
+    return low + (high - low) * RandomValue(rng, 0, 1000000) / 1e6f;
+}
+
+// In the fixed-point build the ball only ever sits on the fixed-point grid
+static float OnGrid(float value) {
+#ifdef PONG_FIXED_POINT
+    return FromFixed(ToFixed(value));
+#else
+    return value;
+#endif
+}
+
+int main() {
+    const int SHOTS = 200000;
+    Rng rng;
+    SeedRng(rng, 12345);
+    int failures = 0;
+
+    for (int i = 0; i < SHOTS; i++) {
+        float speed = Uniform(rng, 1.0f, 40.0f);
+        float angle = Uniform(rng, -85.0f, 85.0f) * 3.14159265f / 180.0f;
+        float direction = i % 2 ? -1.0f : 1.0f;
+        Vector2 velocity = {OnGrid(direction * speed * cosf(angle)), OnGrid(speed * sinf(angle))};
+        Vector2 center = {OnGrid(Uniform(rng, BALL_RADIUS, SCREEN_WIDTH - BALL_RADIUS)),
+                          OnGrid(Uniform(rng, PLAY_AREA_TOP + BALL_RADIUS, PLAY_AREA_BOTTOM - BALL_RADIUS))};
+        Vector2 oldPosition = center - velocity;
+
+        Circle stepped = PointOfCollision({center, NO_COL}, oldPosition);
+        Circle predicted = PredictCollision({center, NO_COL}, oldPosition);
+        if (stepped.Collision != predicted.Collision || !(stepped.center == predicted.center)) {
+            if (failures++ < 10) {
+                printf("PredictCollision c=(%.9g, %.9g) old=(%.9g, %.9g): border %d at (%.9g, %.9g), stepped %d at (%.9g, %.9g)\n",
+                       center.x, center.y, oldPosition.x, oldPosition.y, predicted.Collision, predicted.center.x,
+                       predicted.center.y, stepped.Collision, stepped.center.x, stepped.center.y);
+            }
+        }
+
+        Vector2 read = center - oldPosition; // The velocity the bots see
+        if (read.x <= 0) continue;
+        Circle walked = RightBorderCollision({center, NO_COL}, oldPosition);
+        Intercept intercept = PredictRightIntercept(center, read);
+        if (!intercept.valid || walked.center.y != intercept.y) {
+            if (failures++ < 10) {
+                printf("PredictRightIntercept c=(%.9g, %.9g) old=(%.9g, %.9g): y %.9g, stepped %.9g\n",
+                       center.x, center.y, oldPosition.x, oldPosition.y, intercept.y, walked.center.y);
+            }
+        }
+    }
+
+    printf("%d shots, %d mismatches\n", SHOTS, failures);
+    return failures == 0 ? 0 : 1;
+}
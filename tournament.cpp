@@ -0,0 +1,280 @@
+// pong_tournament - round-robin bot matches on every core
+//
+//   pong_tournament [--matches N] [--threads N] [--seed S] [--max-frames N]
+//                   [--plugin path]... [--scaling] [--frame-by-frame]
+//
+// Matches fast-forward between events (see fast_forward.h), with the same
+// results as stepping every frame; --frame-by-frame steps every frame.
+//
+// Plug-ins are shared libraries exporting
+//   extern "C" void RegisterPongBots(void (*registerBot)(const char* name, BotFunction update));
+
+#include "core.h"
+#include "fast_forward.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+// Bot strategies
+struct BotStrategy {
+    std::string name;
+    BotFunction update;
+};
+
+static std::vector<BotStrategy> strategies;
+static bool frameByFrame = false;
+
+static void RegisterBot(const char* name, BotFunction update) {
+    strategies.push_back({name, update});
+}
+
+typedef void (*PluginEntry)(void (*registerBot)(const char* name, BotFunction update));
+
+static bool LoadPlugin(const char* path) {
+#ifdef _WIN32
+    HMODULE module = LoadLibraryA(path);
+    PluginEntry entry = module ? (PluginEntry)GetProcAddress(module, "RegisterPongBots") : nullptr;
+#else
+    void* module = dlopen(path, RTLD_NOW);
+    PluginEntry entry = module ? (PluginEntry)dlsym(module, "RegisterPongBots") : nullptr;
+#endif
+    if (!entry) {
+        fprintf(stderr, "Could not load bot plug-in %s\n", path);
+        return false;
+    }
+    entry(RegisterBot); // Plug-ins stay loaded until exit
+    return true;
+}
+
+// One match: left bot against right bot until WIN_SCORE (or a frame cap
+// for two bots that never miss)
+struct Match {
+    int left;
+    int right;
+    uint64_t seed;
+};
+
+struct MatchResult {
+    int leftScore;
+    int rightScore;
+    long frames;
+    long paddleHits;
+};
+
+static MatchResult PlayMatch(const Match& match, long maxFrames) {
+    World world;
+    ResetWorld(world, EASY, match.seed);
+    BotFunction left = strategies[match.left].update;
+    BotFunction right = strategies[match.right].update;
+
+    MatchResult result = {0, 0, 0, 0};
+    while (!IsMatchOver(world) && result.frames < maxFrames) {
+        if (frameByFrame) {
+            StepWorldBots(world, left, right);
+            result.frames++;
+        } else {
+            result.frames += FastForwardBots(world, left, right, maxFrames - result.frames);
+        }
+        for (int e = 0; e < world.events.count; e++) {
+            if (world.events.items[e].type == PADDLE_HIT) result.paddleHits++;
+        }
+    }
+    result.leftScore = world.playerScore;
+    result.rightScore = world.botScore;
+    return result;
+}
+
+// Work-stealing pool
+// Every worker owns a deque: it takes work from the back of its own and,
+// once that is empty, steals from the front of a random other one.
+struct WorkerQueue {
+    std::mutex lock;
+    std::deque<int> matches;
+};
+
+static bool PopLocal(WorkerQueue& queue, int& match) {
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.matches.empty()) return false;
+    match = queue.matches.back();
+    queue.matches.pop_back();
+    return true;
+}
+
+static bool Steal(std::vector<WorkerQueue>& queues, int self, Rng& rng, int& match) {
+    int count = (int)queues.size();
+    int start = RandomValue(rng, 0, count - 1);
+    for (int i = 0; i < count; i++) {
+        int victim = (start + i) % count;
+        if (victim == self) continue;
+        std::lock_guard<std::mutex> guard(queues[victim].lock);
+        if (!queues[victim].matches.empty()) {
+            match = queues[victim].matches.front();
+            queues[victim].matches.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Plays every match on 'threads' workers, returns the wall time in seconds.
+// Match seeds are fixed up front, so results don't depend on the thread count.
+static double RunMatches(const std::vector<Match>& matches, std::vector<MatchResult>& results, int threads,
+                         long maxFrames, uint64_t seed) {
+    std::vector<WorkerQueue> queues(threads);
+    for (int i = 0; i < (int)matches.size(); i++) {
+        queues[i % threads].matches.push_back(i);
+    }
+    results.assign(matches.size(), MatchResult{});
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            Rng rng; // Per-thread generator for picking steal victims
+            SeedRng(rng, seed ^ (0x9E3779B97F4A7C15ull * (uint64_t)(t + 1)));
+            int match;
+            while (PopLocal(queues[t], match) || Steal(queues, t, rng, match)) {
+                results[match] = PlayMatch(matches[match], maxFrames);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static long TotalFrames(const std::vector<MatchResult>& results) {
+    long frames = 0;
+    for (const MatchResult& result : results) frames += result.frames;
+    return frames;
+}
+
+static void PrintReport(const std::vector<Match>& matches, const std::vector<MatchResult>& results, double seconds) {
+    int count = (int)strategies.size();
+    std::vector<long> wins(count * count, 0);
+    std::vector<long> played(count * count, 0);
+    std::vector<long> points(count, 0);
+    std::vector<long> hits(count, 0);
+    long draws = 0;
+
+    for (int i = 0; i < (int)matches.size(); i++) {
+        const Match& match = matches[i];
+        const MatchResult& result = results[i];
+        played[match.left * count + match.right]++;
+        played[match.right * count + match.left]++;
+        if (result.leftScore >= WIN_SCORE) wins[match.left * count + match.right]++;
+        else if (result.rightScore >= WIN_SCORE) wins[match.right * count + match.left]++;
+        else {
+            // Its last rally never ended in a point, so its hits would stretch the average
+            draws++;
+            continue;
+        }
+
+        long matchPoints = result.leftScore + result.rightScore;
+        points[match.left] += matchPoints;
+        points[match.right] += matchPoints;
+        hits[match.left] += result.paddleHits;
+        hits[match.right] += result.paddleHits;
+    }
+
+    printf("\nWin rate (row beats column)\n%-12s", "");
+    for (int j = 0; j < count; j++) printf("%10s", strategies[j].name.c_str());
+    printf("%10s%14s\n", "overall", "rally length");
+    for (int i = 0; i < count; i++) {
+        long totalWins = 0;
+        long totalPlayed = 0;
+        printf("%-12s", strategies[i].name.c_str());
+        for (int j = 0; j < count; j++) {
+            long n = played[i * count + j];
+            totalWins += wins[i * count + j];
+            totalPlayed += n;
+            if (i == j || n == 0) printf("%10s", "-");
+            else printf("%9.1f%%", 100.0 * wins[i * count + j] / n);
+        }
+        printf("%9.1f%%", totalPlayed ? 100.0 * totalWins / totalPlayed : 0.0);
+        // Paddle hits per point in the decided matches this bot played
+        printf("%14.2f\n", points[i] ? (double)hits[i] / points[i] : 0.0);
+    }
+
+    long frames = TotalFrames(results);
+    printf("\n%zu matches, %ld draws (frame cap), %ld frames in %.2f s: %.2f M frames/s\n",
+           matches.size(), draws, frames, seconds, frames / seconds / 1e6);
+}
+
+int main(int argc, char** argv) {
+    int matchesPerPair = 100;
+    int threads = (int)std::thread::hardware_concurrency();
+    uint64_t seed = 1;
+    long maxFrames = 1000000;
+    bool scaling = false;
+
+    RegisterBot("easy", BotForDifficulty(EASY));
+    RegisterBot("medium", BotForDifficulty(MEDIUM));
+    RegisterBot("hard", BotForDifficulty(HARD));
+
+    for (int i = 1; i < argc; i++) {
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "--matches") == 0 && next) matchesPerPair = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && next) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && next) seed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--max-frames") == 0 && next) maxFrames = atol(argv[++i]);
+        else if (strcmp(argv[i], "--plugin") == 0 && next) {
+            if (!LoadPlugin(argv[++i])) return 1;
+        }
+        else if (strcmp(argv[i], "--scaling") == 0) scaling = true;
+        else if (strcmp(argv[i], "--frame-by-frame") == 0) frameByFrame = true;
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (threads < 1) threads = 1;
+
+    // Every ordered pair, so each bot plays both sides
+    std::vector<Match> matches;
+    Rng seeds;
+    SeedRng(seeds, seed);
+    for (int left = 0; left < (int)strategies.size(); left++) {
+        for (int right = 0; right < (int)strategies.size(); right++) {
+            if (left == right) continue;
+            for (int m = 0; m < matchesPerPair; m++) {
+                matches.push_back({left, right, RandomBits(seeds)});
+            }
+        }
+    }
+
+    std::vector<MatchResult> results;
+    double seconds = RunMatches(matches, results, threads, maxFrames, seed);
+    printf("%zu bots, %d threads", strategies.size(), threads);
+    PrintReport(matches, results, seconds);
+
+    if (scaling) {
+        printf("\nScaling\n%8s%12s%16s%10s%12s\n", "threads", "seconds", "M frames/s", "speedup", "efficiency");
+        std::vector<int> counts;
+        for (int t = 1; t < threads; t *= 2) counts.push_back(t);
+        counts.push_back(threads);
+
+        double baseline = 0.0;
+        for (int t : counts) {
+            double elapsed = RunMatches(matches, results, t, maxFrames, seed);
+            if (t == 1) baseline = elapsed;
+            double speedup = baseline / elapsed;
+            printf("%8d%12.2f%16.2f%10.2f%11.1f%%\n", t, elapsed, TotalFrames(results) / elapsed / 1e6,
+                   speedup, 100.0 * speedup / t);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include "video.h"
+#include "core.h"
+#include <rlgl.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+static double Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool EndsWith(const char* text, const char* suffix) {
+    size_t length = strlen(text);
+    size_t suffixLength = strlen(suffix);
+    return length >= suffixLength && strcmp(text + length - suffixLength, suffix) == 0;
+}
+
+static size_t Y4mFrameSize(int width, int height) {
+    return 6 + (size_t)width * height * 3 / 2; // "FRAME\n", Y, then U and V at quarter size
+}
+
+// BT.601 full range (C420jpeg), integer math. Chroma is the average of each
+// 2x2 block.
+static void EncodeY4m(const unsigned char* rgba, int width, int height, uint8_t* out) {
+    memcpy(out, "FRAME\n", 6);
+    uint8_t* yPlane = out + 6;
+    uint8_t* uPlane = yPlane + (size_t)width * height;
+    uint8_t* vPlane = uPlane + (size_t)width * height / 4;
+    for (int y = 0; y < height; y += 2) {
+        const unsigned char* rows[2] = {rgba + (size_t)(height - 1 - y) * width * 4, rgba + (size_t)(height - 2 - y) * width * 4};
+        for (int x = 0; x < width; x += 2) {
+            int r = 0, g = 0, b = 0;
+            for (int dy = 0; dy < 2; dy++) {
+                for (int dx = 0; dx < 2; dx++) {
+                    const unsigned char* p = rows[dy] + (x + dx) * 4;
+                    yPlane[(size_t)(y + dy) * width + x + dx] = (uint8_t)((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+            }
+            size_t c = (size_t)(y / 2) * (width / 2) + x / 2;
+            uPlane[c] = (uint8_t)(((-43 * r - 85 * g + 128 * b + 512) >> 10) + 128);
+            vPlane[c] = (uint8_t)(((128 * r - 107 * g - 21 * b + 512) >> 10) + 128);
+        }
+    }
+}
+
+static bool WritePng(const VideoExport& video, VideoSlot& slot, long frame) {
+    // Top row first and opaque; the Y4M buffer is the scratch row
+    size_t rowBytes = (size_t)video.width * 4;
+    uint8_t* scratch = slot.encoded.data();
+    for (int y = 0; y < video.height / 2; y++) {
+        unsigned char* top = slot.pixels + y * rowBytes;
+        unsigned char* bottom = slot.pixels + (video.height - 1 - y) * rowBytes;
+        memcpy(scratch, top, rowBytes);
+        memcpy(top, bottom, rowBytes);
+        memcpy(bottom, scratch, rowBytes);
+    }
+    for (size_t i = 3; i < rowBytes * video.height; i += 4) slot.pixels[i] = 255;
+
+    Image image = {slot.pixels, video.width, video.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+    char path[600];
+    snprintf(path, sizeof(path), "%s/frame-%06ld.png", video.path, frame);
+    return ExportImage(image, path);
+}
+
+// Encoders take frames in order but may finish them out of order
+static void EncodeLoop(VideoExport* video) {
+    for (;;) {
+        long frame;
+        {
+            std::unique_lock<std::mutex> guard(video->lock);
+            video->changed.wait(guard, [video]() { return video->encodeNext < video->submitted || video->closing; });
+            if (video->encodeNext >= video->submitted) return;
+            frame = video->encodeNext++;
+        }
+
+        VideoSlot& slot = video->slots[frame % VIDEO_QUEUE];
+        double start = Now();
+        bool ok = slot.pixels != nullptr;
+        if (ok && video->format == VIDEO_Y4M) EncodeY4m(slot.pixels, video->width, video->height, slot.encoded.data());
+        else if (ok) ok = WritePng(*video, slot, frame);
+        MemFree(slot.pixels);
+        slot.pixels = nullptr;
+
+        {
+            std::lock_guard<std::mutex> guard(video->lock);
+            slot.done = true;
+            if (!ok) video->stats.failures++;
+            video->stats.encodeSeconds += Now() - start;
+        }
+        video->changed.notify_all();
+    }
+}
+
+// The writer hands slots back in frame order, appending Y4M frames as it goes
+static void WriteLoop(VideoExport* video) {
+    size_t size = Y4mFrameSize(video->width, video->height);
+    for (;;) {
+        long frame;
+        {
+            std::unique_lock<std::mutex> guard(video->lock);
+            video->changed.wait(guard, [video]() {
+                if (video->written < video->submitted) return video->slots[video->written % VIDEO_QUEUE].done;
+                return video->closing;
+            });
+            if (video->written >= video->submitted) return;
+            frame = video->written;
+        }
+
+        VideoSlot& slot = video->slots[frame % VIDEO_QUEUE];
+        double start = Now();
+        bool ok = true;
+        if (video->format == VIDEO_Y4M) ok = fwrite(slot.encoded.data(), 1, size, video->file) == size;
+
+        {
+            std::lock_guard<std::mutex> guard(video->lock);
+            slot.done = false;
+            video->written++;
+            video->stats.frames++;
+            if (video->format == VIDEO_Y4M) video->stats.bytes += ok ? (long)size : 0;
+            if (!ok) video->stats.failures++;
+            video->stats.writeSeconds += Now() - start;
+        }
+        video->changed.notify_all();
+    }
+}
+
+bool StartVideoExport(VideoExport& video, const char* path, int width, int height, int fps, int encoders) {
+    video.format = EndsWith(path, ".y4m") ? VIDEO_Y4M : VIDEO_PNG;
+    snprintf(video.path, sizeof(video.path), "%s", path);
+    video.width = width & ~1;
+    video.height = height & ~1;
+    video.fps = fps;
+    if (video.width < 2 || video.height < 2 || fps < 1) return false;
+
+    video.file = nullptr;
+    if (video.format == VIDEO_Y4M) {
+        video.file = fopen(path, "wb");
+        if (!video.file) return false;
+        fprintf(video.file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", video.width, video.height, fps);
+    }
+
+    for (RenderTexture2D& target : video.targets) target = LoadRenderTexture(video.width, video.height);
+    video.rendered = 0;
+    for (VideoSlot& slot : video.slots) {
+        slot.pixels = nullptr;
+        slot.encoded.assign(std::max(Y4mFrameSize(video.width, video.height), (size_t)video.width * 4), 0);
+        slot.done = false;
+    }
+    video.submitted = 0;
+    video.encodeNext = 0;
+    video.written = 0;
+    video.closing = false;
+    video.stats = {};
+
+    for (int i = 0; i < std::max(encoders, 1); i++) video.encoders.emplace_back(EncodeLoop, &video);
+    video.writer = std::thread(WriteLoop, &video);
+    return true;
+}
+
+void BeginVideoFrame(VideoExport& video) {
+    BeginTextureMode(video.targets[video.rendered % VIDEO_TARGETS]);
+    Camera2D camera = {};
+    camera.zoom = fminf((float)video.width / SCREEN_WIDTH, (float)video.height / SCREEN_HEIGHT);
+    camera.offset = {(video.width - SCREEN_WIDTH * camera.zoom) / 2, (video.height - SCREEN_HEIGHT * camera.zoom) / 2};
+    BeginMode2D(camera);
+}
+
+static void ReadBack(VideoExport& video, long frame) {
+    {
+        std::unique_lock<std::mutex> guard(video.lock);
+        if (frame >= video.written + VIDEO_QUEUE) {
+            video.stats.queueWaits++;
+            video.changed.wait(guard, [&video, frame]() { return frame < video.written + VIDEO_QUEUE; });
+        }
+    }
+
+    double start = Now();
+    const RenderTexture2D& target = video.targets[frame % VIDEO_TARGETS];
+    video.slots[frame % VIDEO_QUEUE].pixels =
+        (unsigned char*)rlReadTexturePixels(target.texture.id, video.width, video.height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    video.stats.readSeconds += Now() - start;
+
+    {
+        std::lock_guard<std::mutex> guard(video.lock);
+        video.submitted = frame + 1;
+    }
+    video.changed.notify_all();
+}
+
+void EndVideoFrame(VideoExport& video) {
+    EndMode2D();
+    EndTextureMode(); // Sends the frame to the GPU
+    video.rendered++;
+    if (video.rendered >= VIDEO_TARGETS) ReadBack(video, video.rendered - VIDEO_TARGETS);
+}
+
+void FinishVideoExport(VideoExport& video) {
+    for (long frame = std::max(0L, video.rendered - VIDEO_TARGETS + 1); frame < video.rendered; frame++) {
+        ReadBack(video, frame);
+    }
+    {
+        std::lock_guard<std::mutex> guard(video.lock);
+        video.closing = true;
+    }
+    video.changed.notify_all();
+    for (std::thread& encoder : video.encoders) encoder.join();
+    video.encoders.clear();
+    if (video.writer.joinable()) video.writer.join();
+
+    if (video.file && fclose(video.file) != 0) video.stats.failures++;
+    video.file = nullptr;
+    for (RenderTexture2D& target : video.targets) UnloadRenderTexture(target);
+}
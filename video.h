@@ -0,0 +1,75 @@
+#ifndef PONG_VIDEO_H
+#define PONG_VIDEO_H
+
+#include <raylib.h>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Video export: frames are drawn into a ring of offscreen render textures,
+// as fast as they can be drawn. A frame is read back only after the next
+// one has been sent to the GPU, so the readback doesn't wait for the frame
+// it just queued. Converting and writing run on worker threads while the
+// next frames draw: encoders turn the pixels into a Y4M frame (YUV 4:2:0)
+// or write a PNG each, and a writer appends Y4M frames to the file in order.
+//
+// Needs a GL context: InitWindow (hidden is fine) before StartVideoExport.
+
+const int VIDEO_TARGETS = 2; // Render textures in the ring
+const int VIDEO_QUEUE = 8;   // Frames read back but not yet written
+
+enum VideoFormat {
+    VIDEO_Y4M, // One .y4m file
+    VIDEO_PNG, // A directory of frame-000000.png
+};
+
+struct VideoSlot {
+    unsigned char* pixels;        // RGBA, bottom row first; freed once encoded
+    std::vector<uint8_t> encoded; // Y4M frame, sized once
+    bool done;                    // Encoded, waiting for the writer
+};
+
+struct VideoStats {
+    long frames;        // Through the pipeline, failures included
+    long queueWaits;    // Readbacks that waited for a free slot
+    double readSeconds; // Main thread, in readback
+    double encodeSeconds;
+    double writeSeconds;
+    long bytes;
+    long failures;      // Frames that couldn't be written
+};
+
+struct VideoExport {
+    VideoFormat format;
+    char path[512];
+    int width;
+    int height;
+    int fps;
+    RenderTexture2D targets[VIDEO_TARGETS];
+    long rendered; // Frames drawn
+    FILE* file;
+
+    VideoSlot slots[VIDEO_QUEUE]; // Frame n uses slot n % VIDEO_QUEUE
+    std::mutex lock;
+    std::condition_variable changed;
+    long submitted; // Frames read back
+    long encodeNext;
+    long written;
+    bool closing;
+    std::vector<std::thread> encoders;
+    std::thread writer;
+
+    VideoStats stats;
+};
+
+// A path ending in .y4m is written as one file, anything else is taken as
+// an existing directory for PNG frames. width and height are rounded down
+// to even numbers for the 4:2:0 chroma.
+bool StartVideoExport(VideoExport& video, const char* path, int width, int height, int fps, int encoders);
+void BeginVideoFrame(VideoExport& video); // Then draw in SCREEN_WIDTH x SCREEN_HEIGHT coordinates
+void EndVideoFrame(VideoExport& video);
+void FinishVideoExport(VideoExport& video); // Writes what's left and waits for it
+
+#endif //PONG_VIDEO_H